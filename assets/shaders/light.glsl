@@ -4,9 +4,12 @@
 layout(location = 0) in vec4 position;
 
 uniform mat4 uModel;
-uniform mat4 uView;
-uniform mat4 uProjection;
-uniform mat4 uW2V;
+layout(std140) uniform Camera {
+  mat4 uView;
+  mat4 uProjection;
+  mat4 uW2V;
+  vec4 uCameraPosition;
+};
 
 void main() {
   gl_Position = uW2V * uProjection * uView * uModel * position;
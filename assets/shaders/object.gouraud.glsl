@@ -7,11 +7,13 @@ layout(location = 1) in vec3 normals;
 out vec3 vLightColor; // Result Gouraud color
 
 uniform mat4 uModel;
-uniform mat4 uView;
-uniform mat4 uProjection;
-uniform mat4 uW2V;
-
-uniform vec3 uCameraPosition;
+uniform mat3 uNormalMatrix;  // Inverse transpose of uModel, from the CPU
+layout(std140) uniform Camera {
+  mat4 uView;
+  mat4 uProjection;
+  mat4 uW2V;
+  vec4 uCameraPosition;
+};
 
 struct Material {
   vec3 ambient;
@@ -37,12 +39,39 @@ struct AmbientLight {
 uniform Material uMaterial;
 uniform bool uUseLighting;
 
-#define MAX_POINT_LIGHTS 8
-uniform PointLight uPointLights[MAX_POINT_LIGHTS];
+// Point lights are packed as three RGBA32F texels each:
+// (position, constant), (intensity, linear), (quadratic, -, -, -)
+uniform samplerBuffer uPointLights;
 uniform AmbientLight uAmbientLight;
 
 uniform int uPointLightCount;
 
+PointLight fetchPointLight(int i) {
+  vec4 first = texelFetch(uPointLights, 3 * i);
+  vec4 second = texelFetch(uPointLights, 3 * i + 1);
+  vec4 third = texelFetch(uPointLights, 3 * i + 2);
+
+  return PointLight(first.xyz, second.xyz, first.w, second.w, third.x);
+}
+
+#ifdef CLUSTERED
+// Light clusters, see bloom::LightClusters
+uniform usamplerBuffer uClusters;       // (offset, count) into uClusterLights, one per cluster
+uniform usamplerBuffer uClusterLights;  // Indices into uPointLights
+uniform vec2 uClusterDepth;             // (near plane, depth slice scale)
+
+uvec2 fetchCluster(vec4 clip, float viewDepth) {
+  // Points off screen (or behind the camera) fall back to the border clusters
+  vec2 ndc = clip.xy / max(clip.w, 1e-5);
+  ivec2 tile = clamp(ivec2(floor((ndc * 0.5 + 0.5) * vec2(CLUSTER_GRID_X, CLUSTER_GRID_Y))),
+                     ivec2(0), ivec2(CLUSTER_GRID_X - 1, CLUSTER_GRID_Y - 1));
+  float depth = max(viewDepth, uClusterDepth.x);
+  int slice = clamp(int(floor(log(depth / uClusterDepth.x) * uClusterDepth.y)), 0, CLUSTER_GRID_Z - 1);
+
+  return texelFetch(uClusters, tile.x + CLUSTER_GRID_X * (tile.y + CLUSTER_GRID_Y * slice)).xy;
+}
+#endif
+
 vec3 calculatePointLight(PointLight light, vec3 normal, vec3 fragmentPosition, vec3 viewDirection) {
   // ==== Diffuse Light ====
   vec3 lightDirection = normalize(light.position - fragmentPosition);
@@ -70,21 +99,35 @@ void main() {
   gl_Position = uW2V * uProjection * uView * uModel * position;
 
   vec3 position = vec3(uModel * position);
-  vec3 normal = normalize(mat3(transpose(inverse(uModel))) * normals);
+
+#ifdef CLUSTERED
+  vec4 clip = uProjection * uView * vec4(position, 1.0);
+  float viewDepth = -(uView * vec4(position, 1.0)).z;
+#endif
+
+  vec3 normal = normalize(uNormalMatrix * normals);
 
   // Check if uLightPosition was set
   if (uUseLighting) {
 
-    vec3 viewDirection = normalize(uCameraPosition - position);
+    vec3 viewDirection = normalize(uCameraPosition.xyz - position);
     vec3 result = vec3(0.0);
 
     // Phase 1. Calculate the ambient light (only ambient)
     result += uAmbientLight.intensity * uMaterial.ambient;
 
-    // Phase 2. Calculate the point lights (diffuse and specular) (8 max) (remove ambient after)
+    // Phase 2. Calculate the point lights (diffuse and specular) (remove ambient after)
+#ifdef CLUSTERED
+    uvec2 cluster = fetchCluster(clip, viewDepth);
+    for (uint i = 0u; i < cluster.y; i++) {
+      int light = int(texelFetch(uClusterLights, int(cluster.x + i)).x);
+      result += calculatePointLight(fetchPointLight(light), normal, position, viewDirection);
+    }
+#else
     for (int i = 0; i < uPointLightCount; i++) {
-      result += calculatePointLight(uPointLights[i], normal, position, viewDirection);
+      result += calculatePointLight(fetchPointLight(i), normal, position, viewDirection);
     }
+#endif
 
     // Phase 3. Spot lights
 
@@ -0,0 +1,159 @@
+#shader vertex
+#version 330 core
+
+layout(location = 0) in vec4 position;
+layout(location = 1) in vec3 normals;
+
+// Per-instance attributes
+layout(location = 3) in mat4 iModel;
+layout(location = 7) in vec4 iAmbient;
+layout(location = 8) in vec4 iDiffuse;
+layout(location = 9) in vec4 iSpecular;  // w: shininess
+layout(location = 10) in mat3x4 iNormalMatrix;  // Inverse transpose of iModel, from the CPU
+
+out vec3 vLightColor; // Result Gouraud color
+
+layout(std140) uniform Camera {
+  mat4 uView;
+  mat4 uProjection;
+  mat4 uW2V;
+  vec4 uCameraPosition;
+};
+
+struct Material {
+  vec3 ambient;
+  vec3 diffuse;
+  vec3 specular;
+  float shininess;
+};
+
+struct PointLight {
+  vec3 position;
+
+  vec3 intensity;
+
+  float constant;
+  float linear;
+  float quadratic;
+};
+
+struct AmbientLight {
+  vec3 intensity;
+};
+
+uniform bool uUseLighting;
+
+Material material;
+
+// Point lights are packed as three RGBA32F texels each:
+// (position, constant), (intensity, linear), (quadratic, -, -, -)
+uniform samplerBuffer uPointLights;
+uniform AmbientLight uAmbientLight;
+
+uniform int uPointLightCount;
+
+PointLight fetchPointLight(int i) {
+  vec4 first = texelFetch(uPointLights, 3 * i);
+  vec4 second = texelFetch(uPointLights, 3 * i + 1);
+  vec4 third = texelFetch(uPointLights, 3 * i + 2);
+
+  return PointLight(first.xyz, second.xyz, first.w, second.w, third.x);
+}
+
+#ifdef CLUSTERED
+// Light clusters, see bloom::LightClusters
+uniform usamplerBuffer uClusters;       // (offset, count) into uClusterLights, one per cluster
+uniform usamplerBuffer uClusterLights;  // Indices into uPointLights
+uniform vec2 uClusterDepth;             // (near plane, depth slice scale)
+
+uvec2 fetchCluster(vec4 clip, float viewDepth) {
+  // Points off screen (or behind the camera) fall back to the border clusters
+  vec2 ndc = clip.xy / max(clip.w, 1e-5);
+  ivec2 tile = clamp(ivec2(floor((ndc * 0.5 + 0.5) * vec2(CLUSTER_GRID_X, CLUSTER_GRID_Y))),
+                     ivec2(0), ivec2(CLUSTER_GRID_X - 1, CLUSTER_GRID_Y - 1));
+  float depth = max(viewDepth, uClusterDepth.x);
+  int slice = clamp(int(floor(log(depth / uClusterDepth.x) * uClusterDepth.y)), 0, CLUSTER_GRID_Z - 1);
+
+  return texelFetch(uClusters, tile.x + CLUSTER_GRID_X * (tile.y + CLUSTER_GRID_Y * slice)).xy;
+}
+#endif
+
+vec3 calculatePointLight(PointLight light, vec3 normal, vec3 fragmentPosition, vec3 viewDirection) {
+  // ==== Diffuse Light ====
+  vec3 lightDirection = normalize(light.position - fragmentPosition);
+  
+  float diff = max(dot(normal, lightDirection), 0.0);
+  vec3 diffuse = light.intensity * (diff * material.diffuse);
+
+  // ==== Specular Light ====
+  vec3 reflectDirection = reflect(-lightDirection, normal);
+
+  float spec = pow(max(dot(viewDirection, reflectDirection), 0.0), material.shininess);
+  vec3 specular = light.intensity * (spec * material.specular);
+
+  // ==== Attenuation ====
+  float distance = length(light.position - fragmentPosition);
+  float attenuation = 1.0 / (light.constant + light.linear * distance + light.quadratic * (distance * distance));
+
+  diffuse *= attenuation;
+  specular *= attenuation;
+
+  return (diffuse + specular);
+}
+
+void main() {
+  gl_Position = uW2V * uProjection * uView * iModel * position;
+
+  vec3 position = vec3(iModel * position);
+
+#ifdef CLUSTERED
+  vec4 clip = uProjection * uView * vec4(position, 1.0);
+  float viewDepth = -(uView * vec4(position, 1.0)).z;
+#endif
+
+  vec3 normal = normalize(mat3(iNormalMatrix) * normals);
+
+  material = Material(iAmbient.xyz, iDiffuse.xyz, iSpecular.xyz, iSpecular.w);
+
+  // Check if uLightPosition was set
+  if (uUseLighting) {
+
+    vec3 viewDirection = normalize(uCameraPosition.xyz - position);
+    vec3 result = vec3(0.0);
+
+    // Phase 1. Calculate the ambient light (only ambient)
+    result += uAmbientLight.intensity * material.ambient;
+
+    // Phase 2. Calculate the point lights (diffuse and specular) (remove ambient after)
+#ifdef CLUSTERED
+    uvec2 cluster = fetchCluster(clip, viewDepth);
+    for (uint i = 0u; i < cluster.y; i++) {
+      int light = int(texelFetch(uClusterLights, int(cluster.x + i)).x);
+      result += calculatePointLight(fetchPointLight(light), normal, position, viewDirection);
+    }
+#else
+    for (int i = 0; i < uPointLightCount; i++) {
+      result += calculatePointLight(fetchPointLight(i), normal, position, viewDirection);
+    }
+#endif
+
+    // Phase 3. Spot lights
+
+    vLightColor = vec3(result);
+  } else {
+    vLightColor = vec3(1.0);
+  }
+}
+
+#shader fragment
+#version 330 core
+
+layout(location = 0) out vec4 color;
+
+in vec3 vLightColor;
+
+// uniform vec3 uObjectColor;
+
+void main() {
+  color = vec4(vLightColor, 1.0);
+}
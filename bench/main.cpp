@@ -0,0 +1,314 @@
+// Headless benchmark: renders a generated scene offscreen for a fixed number of frames with a
+// scripted camera and prints frame time statistics as JSON, so runs can be compared between
+// commits.
+//
+//   xmake run bloom_bench --spheres=500 --cubes=500 --lights=64 --clustered --output=run.json
+//
+// The window is never shown. Without a display, pick a context API GLFW can create headless
+// (--context=egl or --context=osmesa, e.g. Mesa llvmpipe) or run under Xvfb.
+
+#include <bloomCG/core/core.hpp>
+#include <bloomCG/core/job_system.hpp>
+#include <bloomCG/core/renderer.hpp>
+#include <bloomCG/scenes/light.hpp>
+#include <bloomCG/structures/hierarchy.hpp>
+
+#include <algorithm>
+#include <chrono>
+#include <random>
+
+struct BenchConfig {
+  uint32_t width = 1280, height = 720;
+  uint32_t frames = 600;
+  uint32_t warmup = 60;  // Frames rendered before measuring (shader compilation, buffer growth)
+  uint32_t spheres = 100, cubes = 100, lights = 16;
+  uint32_t seed = 42;
+  bool instanced = false;
+  bool clustered = false;
+  std::string context = "native";
+  std::string output;  // stdout when empty
+};
+
+struct FrameSample {
+  double cpu;  // onUpdate + onRender submission, milliseconds
+  double gpu;  // GL_TIME_ELAPSED of onRender, milliseconds
+  bloom::RenderStats stats;
+};
+
+struct Summary {
+  double mean, p50, p99, min, max;
+};
+
+static bool parseArguments(int argc, char** argv, BenchConfig& config) {
+  for (int i = 1; i < argc; i++) {
+    const std::string_view argument = argv[i];
+    const std::size_t equals = argument.find('=');
+    const std::string_view key = argument.substr(0, equals);
+    const std::string value
+        = equals == std::string_view::npos ? "" : std::string(argument.substr(equals + 1));
+
+    auto number = [&value]() { return (uint32_t)std::stoul(value); };
+
+    if (key == "--width")
+      config.width = number();
+    else if (key == "--height")
+      config.height = number();
+    else if (key == "--frames")
+      config.frames = std::max(1u, number());
+    else if (key == "--warmup")
+      config.warmup = number();
+    else if (key == "--spheres")
+      config.spheres = number();
+    else if (key == "--cubes")
+      config.cubes = number();
+    else if (key == "--lights")
+      config.lights = number();
+    else if (key == "--seed")
+      config.seed = number();
+    else if (key == "--instanced")
+      config.instanced = true;
+    else if (key == "--clustered")
+      config.clustered = true;
+    else if (key == "--context")
+      config.context = value;
+    else if (key == "--output")
+      config.output = value;
+    else {
+      fmt::print(stderr, "Unknown argument {}\n", argument);
+      return false;
+    }
+  }
+
+  return true;
+}
+
+// Objects laid out on a jittered grid around the origin, reproducible for a given seed
+static void populateScene(const BenchConfig& config) {
+  using bloom::ObjectType;
+
+  std::mt19937 random(config.seed);
+  std::uniform_real_distribution<float> unit(0.f, 1.f);
+
+  const uint32_t objects = config.spheres + config.cubes;
+  const uint32_t side = std::max(1u, (uint32_t)std::ceil(std::sqrt((float)objects)));
+  const float spacing = 3.f;
+
+  auto gridPosition = [&](uint32_t i) {
+    const float x = (i % side - side * .5f) * spacing + unit(random) - .5f;
+    const float z = (i / side - side * .5f) * spacing + unit(random) - .5f;
+    return glm::vec3{x, unit(random) * 2.f - 1.f, z};
+  };
+  auto color = [&]() { return glm::vec3{unit(random), unit(random), unit(random)}; };
+
+  for (uint32_t i = 0; i < objects; i++) {
+    const std::string name = fmt::format("Bench {}", i);
+
+    if (i < config.spheres) {
+      bloom::addToHierarchy(
+          ObjectType::SPHERE, name,
+          new bloom::Sphere(gridPosition(i), color(), .5f + unit(random) * .5f));
+    } else {
+      bloom::addToHierarchy(ObjectType::CUBE, name,
+                            new bloom::Cube(gridPosition(i), 1.f + unit(random), color()));
+    }
+  }
+
+  const float extent = side * spacing * .5f;
+  for (uint32_t i = 0; i < config.lights; i++) {
+    glm::vec3 position{(unit(random) * 2.f - 1.f) * extent, 1.f + unit(random) * 3.f,
+                       (unit(random) * 2.f - 1.f) * extent};
+
+    bloom::addToHierarchy(ObjectType::POINT_LIGHT, fmt::format("Bench Light {}", i),
+                          new bloom::PointLight(position, color()));
+  }
+}
+
+static Summary summarize(std::vector<double> values) {
+  std::sort(values.begin(), values.end());
+
+  auto percentile = [&values](double p) {
+    return values[std::min(values.size() - 1, (std::size_t)(p * values.size()))];
+  };
+
+  double sum = 0.0;
+  for (double value : values) sum += value;
+
+  return {sum / values.size(), percentile(.50), percentile(.99), values.front(), values.back()};
+}
+
+static std::string escape(std::string_view text) {
+  std::string escaped;
+  for (char c : text) {
+    if (c == '"' || c == '\\') escaped += '\\';
+    escaped += c;
+  }
+  return escaped;
+}
+
+static std::string toJson(const BenchConfig& config, const std::vector<FrameSample>& samples) {
+  std::vector<double> cpu, gpu;
+  double drawCalls = 0.0, triangles = 0.0;
+  for (const auto& sample : samples) {
+    cpu.push_back(sample.cpu);
+    gpu.push_back(sample.gpu);
+    drawCalls += sample.stats.drawCalls;
+    triangles += sample.stats.triangles;
+  }
+
+  auto summary = [](const Summary& s) {
+    return fmt::format("{{\"mean\": {:.4f}, \"p50\": {:.4f}, \"p99\": {:.4f}, \"min\": {:.4f}, "
+                       "\"max\": {:.4f}}}",
+                       s.mean, s.p50, s.p99, s.min, s.max);
+  };
+
+  const char* renderer = (const char*)glad_glGetString(GL_RENDERER);
+
+  std::string json = "{\n";
+  json += fmt::format("  \"renderer\": \"{}\",\n", escape(renderer ? renderer : "unknown"));
+  json += fmt::format(
+      "  \"config\": {{\"width\": {}, \"height\": {}, \"frames\": {}, \"warmup\": {}, "
+      "\"spheres\": {}, \"cubes\": {}, \"lights\": {}, \"seed\": {}, \"instanced\": {}, "
+      "\"clustered\": {}}},\n",
+      config.width, config.height, config.frames, config.warmup, config.spheres, config.cubes,
+      config.lights, config.seed, config.instanced, config.clustered);
+  json += fmt::format("  \"cpu_ms\": {},\n", summary(summarize(cpu)));
+  json += fmt::format("  \"gpu_ms\": {},\n", summary(summarize(gpu)));
+  json += fmt::format("  \"draw_calls\": {:.1f},\n", drawCalls / samples.size());
+  json += fmt::format("  \"triangles\": {:.1f}\n", triangles / samples.size());
+  json += "}\n";
+
+  return json;
+}
+
+int main(int argc, char** argv) {
+  BenchConfig config;
+  if (!parseArguments(argc, argv, config)) return 1;
+
+  glfwSetErrorCallback(
+      [](int error, const char* description) { fmt::print(stderr, "Error: {}\n", description); });
+  if (!glfwInit()) return 1;
+
+  glfwWindowHint(GLFW_VISIBLE, GLFW_FALSE);
+  glfwWindowHint(GLFW_CONTEXT_VERSION_MAJOR, 3);
+  glfwWindowHint(GLFW_CONTEXT_VERSION_MINOR, 3);
+  glfwWindowHint(GLFW_OPENGL_PROFILE, GLFW_OPENGL_CORE_PROFILE);
+
+  if (config.context == "egl")
+    glfwWindowHint(GLFW_CONTEXT_CREATION_API, GLFW_EGL_CONTEXT_API);
+  else if (config.context == "osmesa")
+    glfwWindowHint(GLFW_CONTEXT_CREATION_API, GLFW_OSMESA_CONTEXT_API);
+
+  GLFWwindow* window = glfwCreateWindow(config.width, config.height, "BloomCG bench", NULL, NULL);
+  if (!window) {
+    glfwTerminate();
+    return 1;
+  }
+
+  glfwMakeContextCurrent(window);
+  if (!gladLoadGLLoader((GLADloadproc)glfwGetProcAddress)) {
+    glfwTerminate();
+    return 1;
+  }
+
+  bloom::gl::setWindow(window);
+
+  // ==== Offscreen target ====
+  uint32_t fbo, color, depth;
+  GLCall(glad_glGenFramebuffers(1, &fbo));
+  GLCall(glad_glBindFramebuffer(GL_FRAMEBUFFER, fbo));
+
+  GLCall(glad_glGenRenderbuffers(1, &color));
+  GLCall(glad_glBindRenderbuffer(GL_RENDERBUFFER, color));
+  GLCall(glad_glRenderbufferStorage(GL_RENDERBUFFER, GL_RGBA8, config.width, config.height));
+  GLCall(glad_glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_RENDERBUFFER,
+                                        color));
+
+  GLCall(glad_glGenRenderbuffers(1, &depth));
+  GLCall(glad_glBindRenderbuffer(GL_RENDERBUFFER, depth));
+  GLCall(glad_glRenderbufferStorage(GL_RENDERBUFFER, GL_DEPTH24_STENCIL8, config.width,
+                                    config.height));
+  GLCall(glad_glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_DEPTH_STENCIL_ATTACHMENT,
+                                        GL_RENDERBUFFER, depth));
+
+  if (glad_glCheckFramebufferStatus(GL_FRAMEBUFFER) != GL_FRAMEBUFFER_COMPLETE) {
+    fmt::print(stderr, "Framebuffer not complete!\n");
+    return 1;
+  }
+
+  GLCall(glad_glViewport(0, 0, config.width, config.height));
+  bloom::Renderer::setViewportSize(config.width, config.height);  // Level of detail selection
+
+  // ==== Scene ====
+  auto scene = std::make_unique<bloom::scene::Light>();
+  scene->setInstancedRendering(config.instanced)
+      ->setClusteredShading(config.clustered)
+      ->setOrbitLights(true);
+  scene->getCamera()->setAspectRatio((float)config.width / config.height);
+  populateScene(config);
+
+  // ==== Frames ====
+  // The GPU time of a frame is read after the next one is submitted, which also keeps the driver
+  // from queueing more than a frame ahead of the CPU.
+  const double deltaTime = 1.0 / 60.0;
+  const uint32_t totalFrames = config.warmup + config.frames;
+
+  std::array<uint32_t, 2> queries;
+  GLCall(glad_glGenQueries(2, queries.data()));
+
+  std::vector<FrameSample> samples(totalFrames);
+  for (uint32_t frame = 0; frame < totalFrames; frame++) {
+    // Lights orbit with glfwGetTime, pinning it makes every run see the same scene
+    glfwSetTime(frame * deltaTime);
+
+    // Full orbit around the origin over the measured frames
+    const float angle = 2.f * glm::pi<float>() * frame / config.frames;
+    const glm::vec3 eye{std::sin(angle) * 25.f, 8.f, std::cos(angle) * 25.f};
+    scene->getCamera()->setCameraPosition(eye)->setFront(glm::normalize(-eye));
+
+    bloom::Renderer::resetStats();
+
+    const auto start = std::chrono::steady_clock::now();
+    GLCall(glad_glBeginQuery(GL_TIME_ELAPSED, queries[frame % 2]));
+    bloom::JobSystem::get().executeMainThreadJobs();
+    bloom::MeshRegistry::update();
+    bloom::scene::Scene::updatePending();
+    scene->onUpdate(deltaTime);
+    scene->onRender(deltaTime);
+    GLCall(glad_glEndQuery(GL_TIME_ELAPSED));
+    const auto end = std::chrono::steady_clock::now();
+
+    samples[frame].cpu = std::chrono::duration<double, std::milli>(end - start).count();
+    samples[frame].stats = bloom::Renderer::getStats();
+
+    if (frame > 0) {
+      uint64_t elapsed = 0;
+      GLCall(glad_glGetQueryObjectui64v(queries[(frame - 1) % 2], GL_QUERY_RESULT, &elapsed));
+      samples[frame - 1].gpu = elapsed / 1e6;
+    }
+  }
+
+  uint64_t elapsed = 0;
+  GLCall(glad_glGetQueryObjectui64v(queries[(totalFrames - 1) % 2], GL_QUERY_RESULT, &elapsed));
+  samples[totalFrames - 1].gpu = elapsed / 1e6;
+
+  samples.erase(samples.begin(), samples.begin() + config.warmup);
+  const std::string json = toJson(config, samples);
+
+  if (config.output.empty()) {
+    fmt::print("{}", json);
+  } else {
+    std::ofstream file(config.output);
+    file << json;
+  }
+
+  GLCall(glad_glDeleteQueries(2, queries.data()));
+  scene.reset();
+
+  GLCall(glad_glDeleteRenderbuffers(1, &color));
+  GLCall(glad_glDeleteRenderbuffers(1, &depth));
+  GLCall(glad_glDeleteFramebuffers(1, &fbo));
+
+  glfwDestroyWindow(window);
+  glfwTerminate();
+  return 0;
+}
@@ -8,9 +8,9 @@ namespace bloom {
   private:
     uint32_t m_rendererID;
     uint32_t m_count;
-    uint32_t* m_data;
 
   public:
+    // `data` is only read during the upload, no copy is kept on the CPU side
     IndexBuffer(const uint32_t* data, uint32_t count);
     ~IndexBuffer();
 
@@ -18,7 +18,6 @@ namespace bloom {
     void unbind() const;
 
     inline uint32_t getCount() const { return m_count; }
-    inline uint32_t* getData() const { return m_data; }
   };
 
 }  // namespace bloom
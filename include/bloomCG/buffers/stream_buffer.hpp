@@ -0,0 +1,84 @@
+#pragma once
+
+#include <bloomCG/core/common.hpp>
+
+namespace bloom {
+
+  // Block of a StreamBuffer, valid until the end of the frame it was allocated in
+  struct StreamAllocation {
+    void* data = nullptr;  // Write only, the GPU reads it as is
+    uint32_t buffer = 0;   // GL buffer to bind, changes when the ring grows
+    uint32_t offset = 0;   // In `buffer`
+    uint32_t size = 0;
+  };
+
+  // Ring of per-frame regions for data rewritten every frame (instances, uniform blocks...). The
+  // whole buffer is mapped once with persistent, coherent storage: allocations are a bump of the
+  // write head and writes land straight in GPU visible memory, no glBufferData orphaning nor
+  // glBufferSubData copy. Every region is fenced once its frame is submitted, and only written
+  // again when the GPU is done with it.
+  //
+  // Without ARB_buffer_storage (GL < 4.4) writes go to a CPU copy uploaded by `flush`.
+  class StreamBuffer {
+  private:
+    uint32_t m_rendererID = 0;
+    uint32_t m_regionSize;
+    uint32_t m_regionCount;
+
+    uint32_t m_region = 0;   // Written this frame
+    uint32_t m_head = 0;     // Next free byte in the region
+    uint32_t m_flushed = 0;  // Bytes of the region already uploaded, without persistent mapping
+
+    char* m_mapping = nullptr;  // Whole buffer, persistent mapping or CPU copy
+    std::vector<char> m_copy;
+    std::vector<GLsync> m_fences;
+
+    uint32_t m_uniformAlignment;
+    bool m_persistent;
+
+    // Buffers outgrown during the frame, ranges handed out from them may still be bound (and
+    // mapped), so they are only deleted once the frame is submitted
+    std::vector<uint32_t> m_retired;
+    std::vector<std::vector<char>> m_retiredCopies;  // Without persistent mapping
+
+    void create();
+    void destroy();
+    void deleteFences();
+    void releaseRetired();
+
+  public:
+    // Regions the CPU may be ahead of the GPU by
+    static constexpr uint32_t FRAMES_IN_FLIGHT = 3;
+
+    explicit StreamBuffer(uint32_t regionSize, uint32_t regionCount = FRAMES_IN_FLIGHT);
+    ~StreamBuffer();
+
+    StreamBuffer(const StreamBuffer&) = delete;
+    StreamBuffer& operator=(const StreamBuffer&) = delete;
+
+    // Move to the next region, waiting for the GPU if it still reads it
+    void beginFrame();
+
+    // Fence the region, once every draw reading it has been submitted
+    void endFrame();
+
+    // `size` bytes aligned to `alignment`. A region too small for the frame doubles in a new
+    // buffer, the previous allocations of the frame stay valid (and bound) in the old one until
+    // endFrame.
+    StreamAllocation allocate(uint32_t size, uint32_t alignment = 16);
+
+    // Aligned for glBindBufferRange(GL_UNIFORM_BUFFER, ...)
+    inline StreamAllocation allocateUniform(uint32_t size) {
+      return allocate(size, m_uniformAlignment);
+    }
+
+    // Make the writes since the last flush visible before the draws reading them. Nothing to do
+    // with a coherent mapping.
+    void flush();
+
+    inline bool isPersistent() const { return m_persistent; }
+    inline uint32_t getRegionSize() const { return m_regionSize; }
+    inline uint32_t getRendererID() const { return m_rendererID; }
+  };
+
+}  // namespace bloom
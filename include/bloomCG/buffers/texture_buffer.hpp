@@ -0,0 +1,30 @@
+#pragma once
+
+#include <bloomCG/core/common.hpp>
+
+namespace bloom {
+
+  // A buffer object exposed to shaders as a `samplerBuffer`. Unlike uniform blocks its size is only
+  // bounded by GL_MAX_TEXTURE_BUFFER_SIZE, which makes it fit for arrays of unknown length.
+  class TextureBuffer {
+  private:
+    uint32_t m_bufferID;
+    uint32_t m_textureID;
+    uint32_t m_size;
+    uint32_t m_usage;
+
+  public:
+    TextureBuffer(uint32_t size, uint32_t internalFormat = GL_RGBA32F,
+                  uint32_t usage = GL_STREAM_DRAW);
+    ~TextureBuffer();
+
+    void bind(uint32_t slot = 0) const;
+    void unbind(uint32_t slot = 0) const;
+
+    // Replace the whole content of the buffer, growing it when needed
+    void setData(const void* data, uint32_t size);
+
+    inline uint32_t getSize() const { return m_size; }
+  };
+
+}  // namespace bloom
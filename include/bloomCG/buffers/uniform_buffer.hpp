@@ -0,0 +1,14 @@
+#pragma once
+
+#include <bloomCG/core/common.hpp>
+
+namespace bloom {
+
+  // Binding points shared by every program, see Shader::setUniformBlockBinding
+  enum class UniformBinding : uint32_t { Camera = 0 };
+
+  // Point `binding` at `size` bytes of any GL buffer, e.g. a block streamed every frame (see
+  // StreamBuffer::allocateUniform). The layout must follow the std140 rules of the GLSL block.
+  void bindUniformRange(UniformBinding binding, uint32_t buffer, uint32_t offset, uint32_t size);
+
+}  // namespace bloom
@@ -15,6 +15,17 @@ namespace bloom {
     void bind() const;
     void unbind() const;
 
+    inline uint32_t getRendererID() const { return m_rendererID; }
+
     void addBuffer(const VertexBuffer &buffer, const VertexBufferLayout &layout);
+
+    // Attach a per-instance buffer, its attributes start at `firstAttribute` and advance once per
+    // instance instead of once per vertex.
+    void addInstanceBuffer(const VertexBuffer &buffer, const VertexBufferLayout &layout,
+                           uint32_t firstAttribute);
+
+    // Same, for instances starting `offset` bytes into any GL buffer (e.g. a StreamBuffer block)
+    void addInstanceBuffer(uint32_t buffer, uint32_t offset, const VertexBufferLayout &layout,
+                           uint32_t firstAttribute);
   };
 }  // namespace bloom
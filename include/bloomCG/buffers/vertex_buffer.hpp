@@ -7,13 +7,22 @@ namespace bloom {
   class VertexBuffer {
   private:
     uint32_t m_rendererID;
+    uint32_t m_size;
+    uint32_t m_usage;
 
   public:
-    VertexBuffer(const void* data, uint32_t size);
+    VertexBuffer(const void* data, uint32_t size, uint32_t usage = GL_STATIC_DRAW);
     ~VertexBuffer();
 
     void bind() const;
     void unbind() const;
+
+    // Replace the whole content of the buffer, growing it when needed. Meant for buffers created
+    // with GL_DYNAMIC_DRAW/GL_STREAM_DRAW (e.g. per-instance data re-uploaded every frame).
+    void setData(const void* data, uint32_t size);
+
+    inline uint32_t getSize() const { return m_size; }
+    inline uint32_t getRendererID() const { return m_rendererID; }
   };
 
 }  // namespace bloom
@@ -1,5 +1,6 @@
 #pragma once
 
+#include <bloomCG/buffers/vertex_packing.hpp>
 #include <bloomCG/core/common.hpp>
 
 namespace bloom {
@@ -14,11 +15,27 @@ namespace bloom {
           return 4;
         case GL_UNSIGNED_INT:
           return 4;
+        case GL_HALF_FLOAT:
+          return 2;
+        case GL_SHORT:
+          return 2;
+        case GL_UNSIGNED_SHORT:
+          return 2;
+        case GL_BYTE:
+          return 1;
         case GL_UNSIGNED_BYTE:
           return 1;
+        case GL_INT_2_10_10_10_REV:
+          return 4;
       }
       return 0;
     }
+
+    // Bytes taken by the whole attribute, packed types hold all their components in one value
+    inline uint32_t getSize() const {
+      if (type == GL_INT_2_10_10_10_REV) return getSizeOfType(type);
+      return count * getSizeOfType(type);
+    }
   };
 
   class VertexBufferLayout {
@@ -30,7 +47,13 @@ namespace bloom {
     VertexBufferLayout() : m_stride(0) {}
     ~VertexBufferLayout() = default;
 
-    template <typename T> VertexBufferLayout& push(uint32_t count);
+    // Integer types read as floats in shaders, `normalized` maps them to [-1, 1] (signed) or
+    // [0, 1] (unsigned) instead of converting their value as is. Floating point types must not
+    // be normalized.
+    template <typename T> VertexBufferLayout& push(uint32_t count, bool normalized = false);
+
+    // Append an element described at runtime (e.g. read back from a mesh cache file)
+    VertexBufferLayout& push(const VertexBufferLayoutElement& element);
 
     inline const std::vector<VertexBufferLayoutElement>& getElements() const { return m_elements; }
     inline const uint32_t getStride() const { return m_stride; }
@@ -0,0 +1,73 @@
+#pragma once
+
+#include <algorithm>
+#include <bloomCG/core/common.hpp>
+
+namespace bloom {
+  // Storage types of compact vertex attributes, pushed to a VertexBufferLayout like any other type
+  // and filled with the packers below.
+  struct Half {
+    uint16_t bits;  // IEEE 754 binary16 (GL_HALF_FLOAT)
+  };
+
+  struct Packed1010102 {
+    uint32_t bits;  // x, y, z on 10 bits and w on 2, from the low bits (GL_INT_2_10_10_10_REV)
+  };
+
+  namespace pack {
+    // Round to nearest even, out of range values become infinities
+    inline Half half(float value) {
+      uint32_t f;
+      std::memcpy(&f, &value, sizeof(float));
+
+      const uint32_t sign = (f >> 16) & 0x8000;
+      const uint32_t biased = (f >> 23) & 0xff;
+      uint32_t mantissa = f & 0x7fffff;
+
+      // Infinities and NaNs (keeping them NaNs)
+      if (biased == 0xff) return {(uint16_t)(sign | 0x7c00 | (mantissa ? 0x200 : 0))};
+
+      const int32_t exponent = (int32_t)biased - 127 + 15;
+      if (exponent >= 31) return {(uint16_t)(sign | 0x7c00)};
+
+      uint32_t shift = 13;
+      uint32_t bits = sign | (uint32_t)std::max(exponent, 0) << 10;
+      if (exponent <= 0) {
+        // Subnormal: the implicit leading one becomes explicit and the mantissa shifts further
+        if (exponent < -10) return {(uint16_t)sign};
+        mantissa |= 0x800000;
+        shift = 14 - exponent;
+      }
+
+      bits |= mantissa >> shift;
+
+      // A carry out of the mantissa bumps the exponent, which is the correctly rounded result
+      const uint32_t remainder = mantissa & ((1u << shift) - 1);
+      const uint32_t halfway = 1u << (shift - 1);
+      if (remainder > halfway || (remainder == halfway && (bits & 1))) bits++;
+
+      return {(uint16_t)bits};
+    }
+
+    // Signed normalized integers, [-1, 1] mapped to [-max, max]
+    inline int16_t snorm16(float value) {
+      return (int16_t)std::lround(std::clamp(value, -1.f, 1.f) * 32767.f);
+    }
+
+    inline int8_t snorm8(float value) {
+      return (int8_t)std::lround(std::clamp(value, -1.f, 1.f) * 127.f);
+    }
+
+    // Signed normalized 10:10:10:2, enough for unit vectors (e.g. normals, w is usually unused)
+    inline Packed1010102 snorm1010102(const glm::vec3& value, float w = 0.f) {
+      auto component = [](float c, uint32_t bits) {
+        const float max = (float)((1 << (bits - 1)) - 1);
+        const int32_t quantized = (int32_t)std::lround(std::clamp(c, -1.f, 1.f) * max);
+        return (uint32_t)quantized & ((1u << bits) - 1);
+      };
+
+      return {component(value.x, 10) | component(value.y, 10) << 10 | component(value.z, 10) << 20
+              | component(w, 2) << 30};
+    }
+  }  // namespace pack
+}  // namespace bloom
@@ -7,6 +7,14 @@ namespace bloom {
 
   enum class CameraType { PERSPECTIVE, AXONOMETRIC };
 
+  // CPU side of the std140 `Camera` uniform block shared by every shader
+  struct CameraUniformBlock {
+    glm::mat4 view;
+    glm::mat4 projection;
+    glm::mat4 viewport;
+    glm::vec4 position;  // w is unused, vec3 members get padded to 16 bytes anyway
+  };
+
   class Camera : public Entity {
   private:
     glm::vec3 m_cameraPosition, m_cameraFront, m_cameraUp;
@@ -41,6 +49,7 @@ namespace bloom {
     glm::mat4 getViewMatrix() const;
     glm::mat4 getProjectionMatrix() const;
     glm::mat4 getViewportMatrix() const;
+    CameraUniformBlock getUniformBlock() const;
 
     void setViewportU(glm::vec2 u);
     void setViewportV(glm::vec2 v);
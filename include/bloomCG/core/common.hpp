@@ -9,10 +9,12 @@
 #include <imgui_internal.h>
 
 #include <3rd-party/IconFontCppHeaders/IconsFontAwesome5.hpp>
+#include <array>
 #include <bloomCG/core/input.hpp>
 #include <cmath>
 #include <cstddef>
 #include <cstdint>
+#include <cstring>
 #include <filesystem>
 #include <fstream>
 #include <functional>
@@ -23,6 +25,7 @@
 #include <memory>
 #include <sstream>
 #include <string>
+#include <string_view>
 #include <unordered_map>
 #include <vector>
 #include <thread>
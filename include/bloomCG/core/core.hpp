@@ -8,22 +8,54 @@
     asm volatile("int3;");                                \
   }
 
+// Error checking policy of GL calls, picked at build time:
+//  - BLOOM_GL_STRICT: drain and poll glGetError around every call. Pinpoints the failing call but
+//    syncs with the driver each time (`xmake f --gl_strict=y`).
+//  - BLOOM_GL_DEBUG (debug builds): only the call site is recorded, errors are reported by the
+//    KHR_debug callback installed with gl::enableDebugOutput().
+//  - Otherwise (release builds) the bare call.
+#if defined(BLOOM_GL_STRICT)
 #define GLCall(x)          \
   bloom::gl::clearError(); \
   x;                       \
-  ASSERT(bloom::gl::logCall());
+  ASSERT(bloom::gl::logCall(#x, __FILE__, __LINE__));
+#elif defined(BLOOM_GL_DEBUG)
+#define GLCall(x)                                 \
+  bloom::gl::setCallSite(#x, __FILE__, __LINE__); \
+  x;
+#else
+#define GLCall(x) x;
+#endif
 
 // A macro to print the function name
 #define FUNCTION_SIGNATURE() fmt::print("{}:{}\n", __FUNCTION__, __LINE__);
 
 namespace bloom {
   class gl {
+  public:
+    struct CallSite {
+      const char* call;
+      const char* file;
+      int line;
+    };
+
   private:
     static GLFWwindow* window;
+    static CallSite s_callSite;
 
   public:
     static void clearError();
-    static bool logCall();
+    static bool logCall(const char* call, const char* file, int line);
+
+    // Last GLCall issued, what the debug callback blames when the driver reports an error
+    static void setCallSite(const char* call, const char* file, int line) {
+      s_callSite = {call, file, line};
+    }
+    static const CallSite& getCallSite() { return s_callSite; }
+
+    // Install the KHR_debug message callback. Needs a context created with
+    // GLFW_OPENGL_DEBUG_CONTEXT, returns false when the driver doesn't expose the extension.
+    static bool enableDebugOutput();
 
     static void setWindow(GLFWwindow* window);
     static GLFWwindow* getWindow();
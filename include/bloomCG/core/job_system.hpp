@@ -0,0 +1,138 @@
+#pragma once
+
+#include <bloomCG/core/common.hpp>
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <future>
+#include <mutex>
+
+namespace bloom {
+  // Number of jobs left in a group, waited for with JobSystem::wait. Jobs run with it as their
+  // dependency are scheduled once it drops to zero.
+  class JobCounter {
+  private:
+    friend class JobSystem;
+
+    std::atomic<uint32_t> m_count{0};
+    std::mutex m_mutex;
+    std::vector<std::function<void()>> m_continuations;
+
+  public:
+    JobCounter() {}
+
+    JobCounter(const JobCounter&) = delete;
+    JobCounter& operator=(const JobCounter&) = delete;
+
+    // Polling only, a counter must be waited for (JobSystem::wait) before it is destroyed
+    inline bool isDone() const { return m_count.load(std::memory_order_acquire) == 0; }
+  };
+
+  // Worker threads running short jobs for the frame (transforms, culling, ...) and long ones in
+  // the background (mesh generation). Every thread has its own deque: it pushes and pops at the
+  // back, idle threads steal from the front of the others. Jobs must not touch the GL, the
+  // context belongs to the main thread, see runOnMainThread.
+  class JobSystem {
+  private:
+    using Job = std::function<void()>;
+
+    // A mutex per deque, only contended when stealing
+    struct Queue {
+      std::mutex mutex;
+      std::deque<Job> jobs;
+    };
+
+    // Queue 0 belongs to the thread that created the system, the main one, 1.. to the workers
+    std::vector<std::unique_ptr<Queue>> m_queues;
+    std::vector<std::thread> m_workers;
+
+    // Long jobs, only picked by idle workers so they never stall a thread waiting on a counter
+    Queue m_background;
+
+    std::mutex m_mainMutex;
+    std::vector<Job> m_mainJobs;
+
+    std::mutex m_sleepMutex;
+    std::condition_variable m_wake;
+    std::atomic<int32_t> m_queued{0};  // Jobs in the deques, transiently off by a few
+    std::atomic<bool> m_stopping{false};
+
+    static thread_local uint32_t t_queue;
+
+    void push(Job job);
+    void wake();
+    bool pop(Job& job);    // From the queue of the calling thread
+    bool steal(Job& job);  // From the queue of any other thread
+    void finish(JobCounter* counter);
+    void work(uint32_t queue);
+
+  public:
+    // No count: every hardware thread but the main one
+    explicit JobSystem(uint32_t workerCount = 0);
+
+    // Jobs not started yet are dropped, running ones are waited for
+    ~JobSystem();
+
+    JobSystem(const JobSystem&) = delete;
+    JobSystem& operator=(const JobSystem&) = delete;
+
+    // Schedule `job`, counted by `counter` when there's one. With a `dependency` it is only
+    // scheduled once every job of that counter is done.
+    void run(Job job, JobCounter* counter = nullptr, JobCounter* dependency = nullptr);
+
+    // Run the jobs of the calling thread, and steal some, until `counter` drops to zero
+    void wait(JobCounter& counter);
+
+    // Call `function(begin, end)` over ranges of [0, count) of at least `grain` indices, spread
+    // across every thread, the calling one included. Returns once all of them are done.
+    template <typename Function>
+    void parallelFor(std::size_t count, std::size_t grain, const Function& function) {
+      if (count == 0) return;
+
+      grain = std::max<std::size_t>(grain, 1);
+      const std::size_t chunks = std::min(m_queues.size() * 4, (count + grain - 1) / grain);
+      if (chunks <= 1) {
+        function(std::size_t(0), count);
+        return;
+      }
+
+      JobCounter counter;
+      for (std::size_t chunk = 1; chunk < chunks; chunk++) {
+        const std::size_t begin = count * chunk / chunks, end = count * (chunk + 1) / chunks;
+        run([&function, begin, end]() { function(begin, end); }, &counter);
+      }
+
+      function(std::size_t(0), count / chunks);
+      wait(counter);
+    }
+
+    // Long job nothing waits on within the frame, its result is polled from the future
+    template <typename Function>
+    std::future<std::invoke_result_t<Function>> submit(Function&& function) {
+      using Result = std::invoke_result_t<Function>;
+
+      auto task = std::make_shared<std::packaged_task<Result()>>(std::forward<Function>(function));
+      std::future<Result> result = task->get_future();
+      {
+        std::lock_guard<std::mutex> lock(m_background.mutex);
+        m_background.jobs.emplace_back([task]() { (*task)(); });
+      }
+      m_queued++;
+      wake();
+
+      return result;
+    }
+
+    // Queue GL work from any thread, run by the next executeMainThreadJobs
+    void runOnMainThread(Job job);
+
+    // Once per frame on the main thread, before anything is drawn
+    void executeMainThreadJobs();
+
+    // Workers and the main thread
+    inline uint32_t getThreadCount() const { return m_queues.size(); }
+
+    // System shared by the engine, started on first use from the main thread
+    static JobSystem& get();
+  };
+}  // namespace bloom
@@ -0,0 +1,60 @@
+#pragma once
+
+#include <bloomCG/buffers/texture_buffer.hpp>
+#include <bloomCG/core/camera.hpp>
+#include <bloomCG/core/common.hpp>
+#include <bloomCG/models/light.hpp>
+
+namespace bloom {
+
+  // Splits the camera frustum into GRID_X * GRID_Y screen tiles and GRID_Z exponential depth
+  // slices, and lists for every cluster the point lights whose range reaches it. Shaders built with
+  // CLUSTERED look their cluster up and only walk those lights.
+  class LightClusters {
+  public:
+    static constexpr uint32_t GRID_X = 16;
+    static constexpr uint32_t GRID_Y = 9;
+    static constexpr uint32_t GRID_Z = 24;
+    static constexpr uint32_t CLUSTER_COUNT = GRID_X * GRID_Y * GRID_Z;
+
+    // Intensity under which a light stops contributing, used to derive its range
+    static constexpr float LIGHT_CUTOFF = 5.f / 256.f;
+
+  private:
+    struct Bounds {
+      glm::vec3 min, max;
+    };
+
+    // View space bounds of every cluster, only depend on the projection
+    std::vector<Bounds> m_bounds;
+    glm::mat4 m_projection{0.f};
+    float m_near = 0.f, m_far = 0.f;
+
+    // (cluster, light) pairs, counting sorted into `m_lightIndices`
+    std::vector<glm::uvec2> m_pairs;
+    std::vector<glm::uvec2> m_clusters;  // (offset, count) into m_lightIndices
+    std::vector<uint32_t> m_lightIndices;
+
+    std::unique_ptr<bloom::TextureBuffer> m_clusterBuffer;
+    std::unique_ptr<bloom::TextureBuffer> m_lightIndexBuffer;
+
+    void rebuildBounds(const glm::mat4& projection, float near, float far);
+
+  public:
+    LightClusters();
+
+    // Assign `lights` (in the same order as they were uploaded) to the clusters of `camera`
+    void update(const bloom::Camera& camera, const std::vector<bloom::PointLightData>& lights);
+
+    void bind(uint32_t clustersSlot, uint32_t lightIndicesSlot) const;
+
+    // Depth slice of a view space depth is floor(log(depth / near) * scale)
+    float getNearPlane() const { return m_near; }
+    float getDepthScale() const { return GRID_Z / std::log(m_far / m_near); }
+
+    uint32_t getLightIndexCount() const { return (uint32_t)m_lightIndices.size(); }
+
+    static float getLightRange(const bloom::PointLightData& light);
+  };
+
+}  // namespace bloom
@@ -0,0 +1,40 @@
+#pragma once
+
+#include <algorithm>
+#include <bloomCG/core/common.hpp>
+#include <limits>
+
+namespace bloom {
+  namespace lod {
+    // Levels are ordered from the coarsest. Level n > 0 is used from a projected radius of
+    // BASE_RADIUS * 2^n pixels: 8px, 16px, 32px...
+    constexpr float BASE_RADIUS = 4.f;
+
+    // A level is entered HYSTERESIS above its threshold and left HYSTERESIS below it, objects
+    // sitting on a threshold don't flicker between two levels.
+    constexpr float HYSTERESIS = .15f;
+
+    inline float threshold(uint32_t level) { return BASE_RADIUS * (float)(1u << level); }
+
+    // Radius in pixels of a bounding sphere at `distance` from the camera, using the vertical
+    // focal length of the projection (projection[1][1] = 1 / tan(fov / 2))
+    inline float projectedRadius(const glm::mat4& projection, float viewportHeight, float distance,
+                                 float radius) {
+      // Inside (or touching) the sphere, it covers the whole screen
+      if (distance <= radius) return std::numeric_limits<float>::max();
+
+      const float tangent = radius / std::sqrt(distance * distance - radius * radius);
+      return tangent * projection[1][1] * viewportHeight * .5f;
+    }
+
+    // Level to use out of `levels`, given the projected radius and the current level
+    inline uint32_t select(float radius, uint32_t current, uint32_t levels) {
+      uint32_t level = std::min(current, levels - 1);
+
+      while (level + 1 < levels && radius >= threshold(level + 1) * (1.f + HYSTERESIS)) level++;
+      while (level > 0 && radius < threshold(level) * (1.f - HYSTERESIS)) level--;
+
+      return level;
+    }
+  }  // namespace lod
+}  // namespace bloom
@@ -0,0 +1,112 @@
+#pragma once
+
+#include <bloomCG/core/common.hpp>
+
+// Frame profiler, enabled with BLOOM_PROFILE (`xmake f --profiler=y`). Without it every macro
+// below expands to nothing and none of the profiler is compiled in.
+//
+//   BLOOM_PROFILE_FRAME()          once per frame, before anything else is profiled
+//   BLOOM_PROFILE_SCOPE(name)      CPU time until the end of the enclosing block
+//   BLOOM_PROFILE_GPU_SCOPE(name)  GPU time of the GL commands issued until the end of the block
+//   BLOOM_PROFILE_PANEL()          ImGui "Profiler" window
+//
+// `name` must be a string literal (or outlive the profiler). GPU scopes use GL_TIME_ELAPSED
+// queries, which can't be nested: a GPU scope opened inside another one is ignored.
+#ifdef BLOOM_PROFILE
+
+#define BLOOM_PROFILE_CONCAT_(a, b) a##b
+#define BLOOM_PROFILE_CONCAT(a, b) BLOOM_PROFILE_CONCAT_(a, b)
+
+#define BLOOM_PROFILE_FRAME() bloom::Profiler::beginFrame()
+#define BLOOM_PROFILE_SCOPE(name) \
+  bloom::ProfileScope BLOOM_PROFILE_CONCAT(_profileScope, __LINE__)(name)
+#define BLOOM_PROFILE_GPU_SCOPE(name) \
+  bloom::GpuProfileScope BLOOM_PROFILE_CONCAT(_gpuProfileScope, __LINE__)(name)
+#define BLOOM_PROFILE_PANEL() bloom::Profiler::onImGuiRender()
+
+namespace bloom {
+  class Profiler {
+  public:
+    struct Scope {
+      const char* name;
+      uint32_t depth;
+      double start, end;  // Milliseconds since the beginning of the frame
+    };
+
+    struct Frame {
+      double duration = 0.0;     // CPU, milliseconds
+      double gpuDuration = 0.0;  // Sum of the GPU scopes, milliseconds
+      std::vector<Scope> cpuScopes;
+      std::vector<Scope> gpuScopes;  // GPU scopes are laid out one after the other
+      bool gpuResolved = false;
+    };
+
+    static constexpr std::size_t HISTORY_SIZE = 240;
+
+  private:
+    struct GpuQuery {
+      const char* name;
+      uint32_t query;
+    };
+
+    // GPU results of a frame are read two frames later, by then the queries are (nearly always)
+    // done and reading them doesn't stall. The ones that aren't are dropped.
+    static constexpr std::size_t QUERY_BUFFERS = 2;
+
+    static std::array<Frame, HISTORY_SIZE> s_history;
+    static std::size_t s_frameIndex;  // Total number of frames begun
+    static double s_frameStart;
+    static uint32_t s_depth;
+
+    static std::array<std::vector<GpuQuery>, QUERY_BUFFERS> s_gpuQueries;
+    static std::vector<uint32_t> s_freeQueries;
+    static bool s_gpuScopeActive;
+
+    static double now();
+    static Frame& current();
+    static void resolveGpuQueries(std::size_t buffer, Frame& frame);
+
+  public:
+    static void beginFrame();
+
+    static std::size_t beginScope(const char* name);
+    static void endScope(std::size_t index);
+
+    static bool beginGpuScope(const char* name);
+    static void endGpuScope();
+
+    // Last frame with all its data available (GPU results lag behind)
+    static const Frame* getLastResolvedFrame();
+
+    static void onImGuiRender();
+  };
+
+  class ProfileScope {
+  private:
+    std::size_t m_index;
+
+  public:
+    explicit ProfileScope(const char* name) : m_index(Profiler::beginScope(name)) {}
+    ~ProfileScope() { Profiler::endScope(m_index); }
+  };
+
+  class GpuProfileScope {
+  private:
+    bool m_active;
+
+  public:
+    explicit GpuProfileScope(const char* name) : m_active(Profiler::beginGpuScope(name)) {}
+    ~GpuProfileScope() {
+      if (m_active) Profiler::endGpuScope();
+    }
+  };
+}  // namespace bloom
+
+#else
+
+#define BLOOM_PROFILE_FRAME()
+#define BLOOM_PROFILE_SCOPE(name)
+#define BLOOM_PROFILE_GPU_SCOPE(name)
+#define BLOOM_PROFILE_PANEL()
+
+#endif
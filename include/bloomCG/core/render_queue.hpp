@@ -0,0 +1,60 @@
+#pragma once
+
+#include <bloomCG/core/common.hpp>
+#include <bloomCG/core/shader.hpp>
+#include <bloomCG/models/mesh.hpp>
+#include <bloomCG/models/model.hpp>
+
+namespace bloom {
+
+  struct DrawItem {
+    bloom::Shader* shader;
+    bloom::Mesh* mesh;
+    bloom::InstanceData instance;  // Model matrix and material
+    float depth;                   // View space distance, used to order the draws
+    bool translucent = false;
+    uint32_t lod = 0;  // Level of detail of the mesh
+  };
+
+  // Collects the draws of a frame and orders them by a packed 64-bit key, so consecutive items
+  // share as much GL state as possible:
+  //
+  //   opaque      [0][program: 15][mesh: 12][lod: 4][depth: 32]   front to back, helps early-Z
+  //   translucent [1][~depth: 32][program: 15][mesh: 12][lod: 4]  back to front, for blending
+  class RenderQueue {
+  private:
+    struct SortEntry {
+      uint64_t key;
+      uint32_t index;
+    };
+
+    std::vector<DrawItem> m_items;
+    std::vector<SortEntry> m_entries, m_scratch;
+    bool m_sorted = true;
+
+    uint32_t m_programChanges = 0;
+    uint32_t m_meshChanges = 0;
+
+    static uint64_t makeKey(const DrawItem& item);
+    void radixSort();
+
+  public:
+    void submit(const DrawItem& item);
+    void clear();
+
+    // Sort the items submitted so far, `execute` and `operator[]` do it on demand
+    void sort();
+
+    // Issue every item in key order. Programs and meshes are only bound when they change;
+    // `onProgramBind` runs right after a program is bound, for uniforms shared by its draws.
+    void execute(const std::function<void(bloom::Shader*)>& onProgramBind);
+
+    // Items in key order, for callers batching them themselves (e.g. instancing)
+    const DrawItem& operator[](std::size_t index);
+    inline std::size_t size() const { return m_items.size(); }
+
+    // State changes of the last `execute`
+    inline uint32_t getProgramChanges() const { return m_programChanges; }
+    inline uint32_t getMeshChanges() const { return m_meshChanges; }
+  };
+}  // namespace bloom
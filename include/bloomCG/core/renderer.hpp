@@ -2,10 +2,20 @@
 
 #include <imgui.h>
 
+#include <cstdint>
+
 namespace bloom {
+  // Work submitted since the last `Renderer::resetStats`
+  struct RenderStats {
+    uint32_t drawCalls = 0;
+    uint64_t triangles = 0;  // Instances included
+  };
+
   class Renderer {
     // STATIC METHODS
   private:
+    static RenderStats s_stats;
+
     static ImDrawList* s_viewportDrawList;
     static float s_viewportWidth;
     static float s_viewportHeight;
@@ -35,6 +45,14 @@ namespace bloom {
     static float getViewportX() { return Renderer::s_viewportX; }
     static float getViewportY() { return Renderer::s_viewportY; }
 
+    // Draw statistics, fed by every bloom::Mesh draw
+    static void recordDraw(uint64_t triangles) {
+      Renderer::s_stats.drawCalls++;
+      Renderer::s_stats.triangles += triangles;
+    }
+    static const RenderStats& getStats() { return Renderer::s_stats; }
+    static void resetStats() { Renderer::s_stats = {}; }
+
     // METHODS
   public:
     Renderer() = default;
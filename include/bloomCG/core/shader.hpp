@@ -4,6 +4,30 @@
 
 namespace bloom {
 
+  // 32-bit FNV-1a, usable at compile time so literal uniform names cost nothing at runtime
+  constexpr uint32_t hashUniformName(std::string_view name) {
+    uint32_t hash = 2166136261u;
+    for (char c : name) hash = (hash ^ (uint8_t)c) * 16777619u;
+    return hash;
+  }
+
+  struct UniformName {
+    uint32_t hash;
+    std::string_view name;  // Only meant for diagnostics, not owned
+
+    constexpr UniformName(std::string_view name) : hash(hashUniformName(name)), name(name) {}
+    constexpr UniformName(const char *name) : UniformName(std::string_view(name)) {}
+    UniformName(const std::string &name) : UniformName(std::string_view(name)) {}
+  };
+
+  // Resolved uniform location, tagged with the GLSL type it was declared with. Writing through a
+  // handle is a single glUniform* call, no lookup involved.
+  template <typename T> struct Uniform {
+    int32_t location = -1;
+
+    inline bool isValid() const { return location != -1; }
+  };
+
   struct ShaderProgramSource {
     std::string vertexSource;
     std::string fragmentSource;
@@ -12,22 +36,46 @@ namespace bloom {
   class Shader {
   private:
     std::string m_filepath;
+    std::vector<std::string> m_defines;
     uint32_t m_rendererID;
-    std::unordered_map<std::string, int32_t> m_uniformLocationCache;
+    // Every active uniform of the program, reflected after link and keyed by hashed name
+    std::unordered_map<uint32_t, int32_t> m_uniformLocations;
 
   public:
-    Shader(const std::string &filename);
+    // `defines` are injected as `#define <name>` right after the `#version` line of every stage,
+    // letting a single file hold several variants of a program
+    Shader(const std::string &filename, const std::vector<std::string> &defines = {});
     ~Shader();
 
     Shader *bind();
     void unbind() const;
 
-    // Set uniforms
-    Shader *setUniformMat4f(const std::string &name, const glm::mat4 &matrix);
-    Shader *setUniform1f(const std::string &name, const float &value);
-    Shader *setUniform3f(const std::string &name, const glm::vec3 &value);
-    Shader *setUniform4f(const std::string &name, const glm::vec4 &value);
-    Shader *setUniform1i(const std::string &name, int value);
+    inline uint32_t getRendererID() const { return m_rendererID; }
+
+    // Resolve a uniform once, and keep the handle around for the writes
+    template <typename T> Uniform<T> getUniform(UniformName name) {
+      return {getUniformLocation(name)};
+    }
+
+    // Set uniforms through handles
+    Shader *set(Uniform<glm::mat4> uniform, const glm::mat4 &matrix);
+    Shader *set(Uniform<glm::mat3> uniform, const glm::mat3 &matrix);
+    Shader *set(Uniform<float> uniform, float value);
+    Shader *set(Uniform<glm::vec2> uniform, const glm::vec2 &value);
+    Shader *set(Uniform<glm::vec3> uniform, const glm::vec3 &value);
+    Shader *set(Uniform<glm::vec4> uniform, const glm::vec4 &value);
+    Shader *set(Uniform<int32_t> uniform, int32_t value);
+
+    // Set uniforms by name, a hash lookup per call
+    Shader *setUniformMat4f(UniformName name, const glm::mat4 &matrix);
+    Shader *setUniform1f(UniformName name, const float &value);
+    Shader *setUniform2f(UniformName name, const glm::vec2 &value);
+    Shader *setUniform3f(UniformName name, const glm::vec3 &value);
+    Shader *setUniform4f(UniformName name, const glm::vec4 &value);
+    Shader *setUniform1i(UniformName name, int value);
+
+    // Attach the uniform block `name` to a binding point, no-op if the program lacks that block
+    Shader *setUniformBlockBinding(const std::string &name, uint32_t binding);
 
   private:
     [[nodiscard]] uint32_t compileShader(GLenum type, const std::string &source);
@@ -35,6 +83,7 @@ namespace bloom {
                                         const std::string &fragmentShader);
     [[nodiscard]] ShaderProgramSource parseShader(const std::string &filepath);
 
-    [[nodiscard]] int32_t getUniformLocation(const std::string &name);
+    void reflectUniforms();
+    [[nodiscard]] int32_t getUniformLocation(UniformName name);
   };
 }  // namespace bloom
@@ -0,0 +1,34 @@
+#pragma once
+
+#include <bloomCG/core/common.hpp>
+
+namespace bloom {
+  namespace io {
+    // Read-only view of a whole file. Memory mapped where available, pages are loaded by the
+    // kernel as they are touched instead of being copied through a stream buffer.
+    class MappedFile {
+    private:
+      const char* m_data = nullptr;
+      std::size_t m_size = 0;
+      bool m_open = false;
+
+#ifdef _WIN32
+      std::vector<char> m_buffer;  // Read at once, no mapping
+#endif
+
+    public:
+      explicit MappedFile(const std::filesystem::path& path);
+      ~MappedFile();
+
+      MappedFile(const MappedFile&) = delete;
+      MappedFile& operator=(const MappedFile&) = delete;
+
+      // False when the file doesn't exist or can't be read
+      inline bool isOpen() const { return m_open; }
+
+      inline const char* begin() const { return m_data; }
+      inline const char* end() const { return m_data + m_size; }
+      inline std::size_t size() const { return m_size; }
+    };
+  }  // namespace io
+}  // namespace bloom
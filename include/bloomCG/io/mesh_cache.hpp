@@ -0,0 +1,80 @@
+#pragma once
+
+#include <bloomCG/buffers/vertex_buffer_layout.hpp>
+#include <bloomCG/core/common.hpp>
+#include <bloomCG/models/mesh.hpp>
+
+namespace bloom {
+  namespace io {
+    // ==== .bmesh files ====
+    // | MeshFileHeader | attributes | LOD table | vertex blob | index blob |
+    // Every section starts on a 16 bytes boundary, so a mapped file can be handed to the GL as
+    // is. Values are little endian, like every platform the engine runs on.
+    constexpr char MESH_FILE_MAGIC[4] = {'B', 'M', 'S', 'H'};
+    constexpr uint32_t MESH_FILE_VERSION = 1;
+
+    struct MeshFileHeader {
+      char magic[4];
+      uint32_t version;
+
+      // Identifies what the mesh was built from (source file content, generator parameters),
+      // a mismatch means the cache is stale
+      uint64_t sourceHash;
+
+      uint32_t attributeCount;  // VertexBufferLayoutElement entries
+      uint32_t stride;
+      uint32_t vertexCount;
+      uint32_t indexCount;
+      uint32_t lodCount;  // MeshLod entries, 0 when the index buffer is a single level
+      uint32_t reserved;
+
+      float boundsMin[3];
+      float boundsMax[3];
+      float acmrBefore, acmrAfter;
+
+      uint64_t attributesOffset;
+      uint64_t lodsOffset;
+      uint64_t verticesOffset;
+      uint64_t indicesOffset;
+    };
+    static_assert(sizeof(MeshFileHeader) == 104);
+
+    // 64-bit hash of a block of memory, fast enough to fingerprint large source files. `seed`
+    // chains several blocks into one hash.
+    uint64_t hashBytes(const void* data, std::size_t size, uint64_t seed = 0);
+
+    template <typename... Values> uint64_t hashValues(const Values&... values) {
+      uint64_t hash = 0;
+      ((hash = hashBytes(&values, sizeof(values), hash)), ...);
+      return hash;
+    }
+
+    class MeshCache {
+    private:
+      static std::filesystem::path s_directory;
+      static bool s_enabled;
+
+    public:
+      // Smaller meshes are rebuilt faster than they are read back, they aren't written
+      static constexpr uint32_t MIN_CACHED_BYTES = 256 * 1024;
+
+      static inline void setDirectory(const std::filesystem::path& directory) {
+        s_directory = directory;
+      }
+      static inline const std::filesystem::path& getDirectory() { return s_directory; }
+      static inline void setEnabled(bool enabled) { s_enabled = enabled; }
+      static inline bool isEnabled() { return s_enabled; }
+
+      // Map `name` into `data`, which keeps the file mapped so the upload reads straight from
+      // its pages. False when there is no cache, or when it is stale (`sourceHash` differs),
+      // from another version or damaged. Safe to call from any thread.
+      static bool load(const std::string& name, uint64_t sourceHash, bloom::MeshData& data);
+
+      // Write `name`, replacing any previous version. Failures only cost the next load a rebuild,
+      // they are reported and otherwise ignored. Safe to call from any thread.
+      static void store(const std::string& name, uint64_t sourceHash, const bloom::MeshData& data);
+
+      static std::filesystem::path getPath(const std::string& name);
+    };
+  }  // namespace io
+}  // namespace bloom
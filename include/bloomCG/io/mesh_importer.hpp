@@ -0,0 +1,39 @@
+#pragma once
+
+#include <bloomCG/buffers/vertex_buffer_layout.hpp>
+#include <bloomCG/core/common.hpp>
+#include <bloomCG/models/mesh.hpp>
+
+namespace bloom {
+  namespace io {
+    // Imported meshes are normalized into the [-1, 1] cube like the unit sphere and cube, which
+    // keeps the same compact vertex: snorm16 position (w = 1) and 10:10:10:2 normal. The normal
+    // is repeated as the face normal read by the flat shaders, faces share their vertices.
+    struct ImportedVertex {
+      std::array<int16_t, 4> position;
+      Packed1010102 normal;
+      Packed1010102 faceNormal;
+    };
+    static_assert(sizeof(ImportedVertex) == 16);
+
+    struct ImportedMesh {
+      std::vector<ImportedVertex> vertices;
+      std::vector<uint32_t> indices;
+
+      // Original placement of the geometry: file position = center + position * extent
+      glm::vec3 center{0.f};
+      float extent = 1.f;
+      MeshBounds bounds;  // Of the normalized vertices, only the widest axis spans [-1, 1]
+
+      static bloom::VertexBufferLayout getLayout();
+    };
+
+    // Bumped whenever the import produces different vertices, cached imports are rebuilt then
+    constexpr uint32_t IMPORTER_VERSION = 1;
+
+    // Load a Wavefront .obj or a .ply (ascii or binary) file, the format is picked from the
+    // extension. The file is memory mapped and parsed in parallel, line aligned chunks for text
+    // and record ranges for binary data. Returns false and fills `error` on failure.
+    bool importMesh(const std::filesystem::path& path, ImportedMesh& mesh, std::string& error);
+  }  // namespace io
+}  // namespace bloom
@@ -1,11 +1,8 @@
 #pragma once
 
-#include <bloomCG/buffers/index_buffer.hpp>
-#include <bloomCG/buffers/vertex_array.hpp>
-#include <bloomCG/buffers/vertex_buffer.hpp>
-#include <bloomCG/buffers/vertex_buffer_layout.hpp>
 #include <bloomCG/core/core.hpp>
 #include <bloomCG/core/shader.hpp>
+#include <bloomCG/models/mesh.hpp>
 #include <bloomCG/models/model.hpp>
 
 namespace bloom {
@@ -19,44 +16,24 @@ namespace bloom {
 
   class Cube : public Object {
   protected:
-    static bloom::IndexBuffer *m_indexBuffer;
-    static bloom::VertexBufferLayout *m_vertexBufferIndexedLayout;
-    static bloom::VertexBufferLayout *m_vertexBufferRepeatedLayout;
-
-  protected:
-    float m_size;
-    glm::vec3 m_position;
+    float m_size;  // Half of the side, the unit cube spans [-1, 1]
     CubeType m_type;
 
-    std::vector<float> m_vertices;
-    std::vector<glm::vec3> m_normals;
-    std::vector<unsigned int> m_indices;
-
-    std::vector<float> m_vertexData;
+    // Unit cube shared by every cube of the same type, position and size only change the model
+    // matrix
+    std::shared_ptr<bloom::Mesh> m_mesh;
 
-    bloom::VertexArray *m_vertexArray;
-    std::unique_ptr<bloom::VertexBuffer> m_vertexBuffer;
+    void acquireMesh();
 
-    void generateIndexedVertices();
-    void generateRepeatedVertices();
-    void generateNormals();
-
-    void setupBuffers();
-    void buildIndexedVertexData();
-    void buildRepeatedVertexData();
-
-    uint32_t *getIndices();
+    static std::shared_ptr<bloom::Mesh> generateIndexedMesh();
+    static std::shared_ptr<bloom::Mesh> generateRepeatedMesh();
 
   public:
     Cube(glm::vec3 position, float side = 2.f, glm::vec3 color = glm::vec3{.0, 1., 1.},
          CubeType type = CubeType::REPEATED);
 
-    void draw();
     void print();
 
-    glm::vec3 getPosition();
-    void setPosition(glm::vec3 position);
-
     void setSide(float side);
 
     float getSide();
@@ -0,0 +1,35 @@
+#pragma once
+
+#include <bloomCG/core/common.hpp>
+#include <bloomCG/models/mesh.hpp>
+#include <bloomCG/models/model.hpp>
+
+namespace bloom {
+  // Object drawing a mesh loaded from a file (see bloom::io::importMesh). The geometry is fitted
+  // into the [-1, 1] cube, `size` scales it like the half side of a cube.
+  class Model : public Object {
+  private:
+    std::string m_path;
+    float m_size;
+
+    // Shared with every model loaded from the same file
+    std::shared_ptr<bloom::Mesh> m_mesh;
+
+  public:
+    // Import the file, or reuse the mesh already loaded from it. Null when it can't be imported,
+    // `error` says why.
+    static std::shared_ptr<bloom::Mesh> loadMesh(const std::filesystem::path& path,
+                                                 std::string& error);
+
+    Model(std::shared_ptr<bloom::Mesh> mesh, const std::string& path, glm::vec3 position,
+          float size = 1.f, glm::vec3 color = glm::vec3{.8, .8, .8});
+    ~Model() {}
+
+    inline const std::string& getPath() const { return m_path; }
+
+    float getSize();
+    void setSize(float size);
+
+    void print();
+  };
+}  // namespace bloom
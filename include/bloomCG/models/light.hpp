@@ -5,6 +5,15 @@
 #include "bloomCG/models/model.hpp"
 
 namespace bloom {
+  // Layout of a point light in the lights texture buffer, three RGBA32F texels per light
+  struct PointLightData {
+    glm::vec3 position;
+    float constant;
+    glm::vec3 intensity;
+    float linear;
+    float quadratic;
+    float padding[3];
+  };
   // Create this class just for verbose purposes.
   // TODO: Make light entity, and then PointLight inherit exclusively from it.
   class Light : public Sphere {
@@ -12,10 +21,8 @@ namespace bloom {
     explicit Light(glm::vec3 position);
   };
 
+  // State in the ecs::AmbientLight of the entity
   class AmbientLight : public Entity {
-  private:
-    glm::vec3 m_ambientIntensity;
-
   public:
     explicit AmbientLight(glm::vec3 ambientIntensity);
 
@@ -26,13 +33,8 @@ namespace bloom {
     glm::vec3 getIntensity() const;
   };
 
+  // State in the ecs::PointLight of the entity, the position is its ecs::Transform
   class PointLight : public Light {
-  private:
-    glm::vec3 m_intensity;
-    float m_constant;
-    float m_linear;
-    float m_quadratic;
-
   public:
     explicit PointLight(glm::vec3 position, glm::vec3 intensity = glm::vec3{1},
                         float constant = 1.0f, float linear = 0.09f, float quadratic = 0.032f);
@@ -47,5 +49,9 @@ namespace bloom {
     float getConstant() const;
     float getLinear() const;
     float getQuadratic() const;
+
+    PointLightData getLightData();
+    static PointLightData getLightData(const ecs::Transform& transform,
+                                       const ecs::PointLight& light);
   };
 }  // namespace bloom
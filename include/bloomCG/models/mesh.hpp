@@ -0,0 +1,198 @@
+#pragma once
+
+#include <algorithm>
+#include <bloomCG/buffers/index_buffer.hpp>
+#include <bloomCG/buffers/vertex_array.hpp>
+#include <bloomCG/buffers/vertex_buffer.hpp>
+#include <bloomCG/buffers/vertex_buffer_layout.hpp>
+#include <bloomCG/core/common.hpp>
+#include <future>
+
+namespace bloom {
+
+  // Index range of one level of detail, levels of a mesh share its vertex and index buffers
+  struct MeshLod {
+    uint32_t firstIndex;
+    uint32_t indexCount;
+  };
+
+  // Average cache miss ratio of the index buffer around its optimization, see bloom::meshopt
+  struct MeshCacheStats {
+    float acmrBefore = 0.f;
+    float acmrAfter = 0.f;
+  };
+
+  // Axis aligned box around the vertices, in mesh space
+  struct MeshBounds {
+    glm::vec3 min{-1.f};
+    glm::vec3 max{1.f};
+  };
+
+  // CPU side of a geometry, built anywhere and uploaded on the main thread. The arrays point into
+  // `storage`, which keeps them alive: the generator's vectors or a mapped cache file.
+  struct MeshData {
+    const void *vertices = nullptr;
+    uint32_t vertexBytes = 0;
+    bloom::VertexBufferLayout layout;
+    const uint32_t *indices = nullptr;
+    uint32_t indexCount = 0;
+    std::vector<MeshLod> lods;
+    MeshBounds bounds;
+    MeshCacheStats stats;
+    std::shared_ptr<const void> storage;
+
+    inline bool isEmpty() const { return vertexBytes == 0; }
+
+    // Take ownership of generated arrays
+    template <typename Vertex>
+    static MeshData from(std::vector<Vertex> &&vertices, const bloom::VertexBufferLayout &layout,
+                         std::vector<uint32_t> &&indices = {},
+                         const std::vector<MeshLod> &lods = {}, const MeshCacheStats &stats = {}) {
+      using Arrays = std::pair<std::vector<Vertex>, std::vector<uint32_t>>;
+      auto arrays = std::make_shared<Arrays>(std::move(vertices), std::move(indices));
+
+      MeshData data;
+      data.vertices = arrays->first.data();
+      data.vertexBytes = arrays->first.size() * sizeof(Vertex);
+      data.layout = layout;
+      data.indices = arrays->second.data();
+      data.indexCount = arrays->second.size();
+      data.lods = lods;
+      data.stats = stats;
+      data.storage = std::move(arrays);
+
+      return data;
+    }
+  };
+
+  // GPU side of a geometry: the vertex/index buffers and the vertex array describing them.
+  class Mesh {
+  private:
+    std::unique_ptr<bloom::VertexBuffer> m_vertexBuffer;
+    std::unique_ptr<bloom::IndexBuffer> m_indexBuffer;  // Null for non-indexed geometry
+    std::unique_ptr<bloom::VertexArray> m_vertexArray;
+    bloom::VertexBufferLayout m_layout;
+
+    uint32_t m_vertexCount;
+
+    // Empty when the whole index buffer is a single level
+    std::vector<MeshLod> m_lods;
+
+    MeshCacheStats m_cacheStats;
+    MeshBounds m_bounds;
+
+  public:
+    // `vertices` holds `size` bytes laid out as described by `layout`. Both arrays are only read
+    // during the upload, they can point to a mapped file.
+    Mesh(const void *vertices, uint32_t size, const bloom::VertexBufferLayout &layout,
+         const uint32_t *indices = nullptr, uint32_t indexCount = 0,
+         const std::vector<MeshLod> &lods = {});
+
+    // Any vertex struct (or plain floats) matching the layout
+    template <typename Vertex>
+    Mesh(const std::vector<Vertex> &vertices, const bloom::VertexBufferLayout &layout,
+         const std::vector<uint32_t> &indices = {}, const std::vector<MeshLod> &lods = {})
+        : Mesh(vertices.data(), vertices.size() * sizeof(Vertex), layout, indices.data(),
+               indices.size(), lods) {}
+
+    // Upload, bounds and cache stats included
+    explicit Mesh(const MeshData &data);
+
+    ~Mesh() = default;
+
+    void draw(uint32_t lod = 0) const;
+    void drawInstanced(uint32_t instanceCount, uint32_t lod = 0) const;
+
+    // Lower level pair for callers that track bindings themselves (see RenderQueue): `bind` once,
+    // then `submit` as many draws as needed. Switching levels of detail needs no rebinding.
+    void bind() const;
+    void unbind() const;
+    void submit(uint32_t instanceCount = 1, uint32_t lod = 0) const;
+
+    inline bloom::VertexArray *getVertexArray() const { return m_vertexArray.get(); }
+    inline uint32_t getVertexCount() const { return m_vertexCount; }
+    inline uint32_t getIndexCount() const { return m_indexBuffer ? m_indexBuffer->getCount() : 0; }
+
+    inline const MeshCacheStats &getCacheStats() const { return m_cacheStats; }
+    inline void setCacheStats(const MeshCacheStats &stats) { m_cacheStats = stats; }
+
+    inline const MeshBounds &getBounds() const { return m_bounds; }
+    inline void setBounds(const MeshBounds &bounds) { m_bounds = bounds; }
+
+    // Levels are ordered from the coarsest to the finest, out of range levels clamp to the last
+    inline uint32_t getLodCount() const { return m_lods.empty() ? 1 : m_lods.size(); }
+    inline uint32_t getTriangleCount(uint32_t lod = 0) const {
+      if (!m_lods.empty()) return m_lods[std::min(lod, getLodCount() - 1)].indexCount / 3;
+      return (m_indexBuffer ? m_indexBuffer->getCount() : m_vertexCount) / 3;
+    }
+  };
+
+  enum class MeshType { SPHERE, CUBE, ICOSPHERE };
+
+  // Generator parameters identifying a geometry, two objects asking for the same key share the
+  // same buffers.
+  struct MeshKey {
+    MeshType type;
+    std::array<uint32_t, 5> params;
+
+    bool operator==(const MeshKey &other) const {
+      return type == other.type && params == other.params;
+    }
+  };
+
+  struct hash_mesh_key {
+    size_t operator()(const MeshKey &key) const {
+      size_t hash = std::hash<MeshType>()(key.type);
+      for (uint32_t param : key.params)
+        hash ^= std::hash<uint32_t>()(param) + 0x9e3779b9 + (hash << 6) + (hash >> 2);
+      return hash;
+    }
+  };
+
+  // Mesh being generated in the background, see MeshRegistry::request
+  struct MeshRequest {
+    MeshKey key;
+    std::future<MeshData> data;
+    std::shared_ptr<Mesh> mesh;  // Set by MeshRegistry::update once uploaded
+
+    inline bool isReady() const { return mesh != nullptr; }
+  };
+
+  class MeshRegistry {
+  private:
+    // The registry doesn't keep meshes alive, the last object releasing its handle frees the GPU
+    // buffers. The expired entry is reused by the next lookup of its key, and pruned by
+    // getMeshCount otherwise.
+    static std::unordered_map<MeshKey, std::weak_ptr<Mesh>, hash_mesh_key> s_meshes;
+
+    // Meshes loaded from files, keyed by path
+    static std::unordered_map<std::string, std::weak_ptr<Mesh>> s_files;
+
+    // Requests being generated. Only their owners keep them alive, a request dropped before its
+    // job starts is never generated, one dropped later is never uploaded.
+    static std::unordered_map<MeshKey, std::weak_ptr<MeshRequest>, hash_mesh_key> s_requests;
+
+  public:
+    static std::shared_ptr<Mesh> acquire(const MeshKey &key,
+                                         const std::function<std::shared_ptr<Mesh>()> &build);
+
+    // `build` may fail and return null, nothing is cached then
+    static std::shared_ptr<Mesh> acquire(const std::string &path,
+                                         const std::function<std::shared_ptr<Mesh>()> &build);
+
+    // Generate `key` in the background (see JobSystem::submit) unless it is alive or already
+    // requested. The request is ready at once when the mesh exists.
+    static std::shared_ptr<MeshRequest> request(const MeshKey &key,
+                                                std::function<MeshData()> generate);
+
+    // Upload the finished requests, once per frame before anything is drawn so objects swap to
+    // their new meshes at a frame boundary. At least one request is uploaded per call, then
+    // only as long as `byteBudget` isn't exceeded, larger batches wait for the next frames.
+    static void update(std::size_t byteBudget = UPLOAD_BUDGET);
+
+    static constexpr std::size_t UPLOAD_BUDGET = 16 << 20;
+
+    // Number of distinct meshes currently alive
+    static std::size_t getMeshCount();
+  };
+}  // namespace bloom
@@ -0,0 +1,86 @@
+#pragma once
+
+#include <bloomCG/core/common.hpp>
+#include <bloomCG/models/mesh.hpp>
+
+namespace bloom {
+  // Index buffer passes run on generated/loaded geometry before it is uploaded. Index ranges are
+  // [first, first + count) so the levels of a mesh (see MeshLod) are optimized independently.
+  namespace meshopt {
+    // FIFO post-transform cache size assumed by the passes, a conservative value for current GPUs
+    constexpr uint32_t CACHE_SIZE = 16;
+
+    // Average cache miss ratio: vertices transformed per triangle with a FIFO cache, starting
+    // cold. 3 means no reuse at all, about 0.6 is the best a regular grid gets.
+    float acmr(const std::vector<uint32_t>& indices, uint32_t first, uint32_t count,
+               uint32_t vertexCount, uint32_t cacheSize = CACHE_SIZE);
+
+    // Tipsify (Sander et al. 2007): reorder the triangles of the range so vertices are reused
+    // while still in the cache. The first triangle of every cluster (a run ending on a dead end,
+    // where the cache has to be refilled) is appended to `clusters`, relative to `first`.
+    void optimizeVertexCache(std::vector<uint32_t>& indices, uint32_t first, uint32_t count,
+                             uint32_t vertexCount, uint32_t cacheSize = CACHE_SIZE,
+                             std::vector<uint32_t>* clusters = nullptr);
+
+    // Reorder the clusters found by optimizeVertexCache so the ones facing away from the center
+    // of the range are drawn first and occlude the others, triangles inside a cluster keep their
+    // cache friendly order.
+    void optimizeOverdraw(std::vector<uint32_t>& indices, uint32_t first, uint32_t count,
+                          const std::vector<uint32_t>& clusters,
+                          const std::vector<glm::vec3>& positions);
+
+    // Renumber vertices in the order the index buffer first uses them, so fetches walk the
+    // vertex buffer forward. Returns the new index of every vertex, unused ones go last.
+    std::vector<uint32_t> optimizeVertexFetch(std::vector<uint32_t>& indices,
+                                              uint32_t vertexCount);
+
+    template <typename Vertex>
+    void remapVertices(std::vector<Vertex>& vertices, const std::vector<uint32_t>& remap) {
+      std::vector<Vertex> remapped(vertices.size());
+      for (uint32_t vertex = 0; vertex < vertices.size(); vertex++)
+        remapped[remap[vertex]] = vertices[vertex];
+
+      vertices.swap(remapped);
+    }
+
+    // Every pass in order, on each level of the mesh (or the whole index buffer without levels).
+    // Overdraw is only optimized when `positions` are given, one per vertex.
+    template <typename Vertex>
+    MeshCacheStats optimize(std::vector<Vertex>& vertices, std::vector<uint32_t>& indices,
+                            const std::vector<MeshLod>& lods = {},
+                            const std::vector<glm::vec3>* positions = nullptr) {
+      const uint32_t vertexCount = vertices.size();
+      std::vector<MeshLod> ranges = lods;
+      if (ranges.empty()) ranges.push_back({0, (uint32_t)indices.size()});
+
+      MeshCacheStats stats;
+      uint32_t triangles = 0;
+      std::vector<uint32_t> clusters;
+
+      for (const MeshLod& range : ranges) {
+        const uint32_t rangeTriangles = range.indexCount / 3;
+        stats.acmrBefore
+            += acmr(indices, range.firstIndex, range.indexCount, vertexCount) * rangeTriangles;
+
+        clusters.clear();
+        optimizeVertexCache(indices, range.firstIndex, range.indexCount, vertexCount, CACHE_SIZE,
+                            &clusters);
+        if (positions)
+          optimizeOverdraw(indices, range.firstIndex, range.indexCount, clusters, *positions);
+
+        stats.acmrAfter
+            += acmr(indices, range.firstIndex, range.indexCount, vertexCount) * rangeTriangles;
+        triangles += rangeTriangles;
+      }
+
+      if (triangles > 0) {
+        stats.acmrBefore /= triangles;
+        stats.acmrAfter /= triangles;
+      }
+
+      remapVertices(vertices, optimizeVertexFetch(indices, vertexCount));
+
+      return stats;
+    }
+  }  // namespace meshopt
+}  // namespace bloom
@@ -1,27 +1,53 @@
 #pragma once
 
 #include <bloomCG/core/common.hpp>
+#include <bloomCG/structures/components.hpp>
+#include <bloomCG/structures/registry.hpp>
 
 namespace bloom {
+  class Mesh;
+
+  // Per-instance attributes consumed by the instanced object shaders (locations 3 to 12).
+  struct InstanceData {
+    glm::mat4 model;
+    glm::vec4 ambient;   // xyz: Ka
+    glm::vec4 diffuse;   // xyz: Kd
+    glm::vec4 specular;  // xyz: Ks, w: shininess
+    glm::mat3x4 normal;  // Normal matrix of model, columns padded to vec4
+  };
+
+  // Handle over an entity of ecs::registry, created with it and destroying it along. The state
+  // lives in the components of the entity, classes only keep what is theirs (e.g. mesh
+  // ownership) and the behaviour.
   class Entity {
+  protected:
+    ecs::EntityID m_entity;
+
   public:
+    Entity();
+    virtual ~Entity();
+
+    Entity(const Entity&) = delete;
+    Entity& operator=(const Entity&) = delete;
+
+    inline ecs::EntityID getEntityID() const { return m_entity; }
+
     // Set and get position virtual
     virtual glm::vec3 getPosition() = 0;
     virtual void setPosition(glm::vec3 position) = 0;
   };
 
+  // Entity with an ecs::Transform, ecs::Material and ecs::Renderable
   class Object : public Entity {
-  public:
-    enum class Shading { FLAT, GOURAUD, PHONG, BLINN };
+  protected:
+    inline ecs::Transform& transform() { return ecs::registry.get<ecs::Transform>(m_entity); }
+    inline ecs::Material& material() { return ecs::registry.get<ecs::Material>(m_entity); }
+    inline ecs::Renderable& renderable() { return ecs::registry.get<ecs::Renderable>(m_entity); }
 
-    glm::vec3 m_objectKa, m_objectKd, m_objectKs;
-    float m_objectShininess;
-
-    glm::vec3 m_appliedTransformation = glm::vec3(0.0f);
-    glm::vec3 m_appliedRotation = glm::vec3(0.0f);
-    glm::vec3 m_appliedScale = glm::vec3(1.0f);
+  public:
+    using Shading = ecs::Shading;
 
-    Shading m_shading = Shading::PHONG;
+    Object();
 
     glm::vec3 getAppliedRotation();
     glm::vec3 getAppliedScale();
@@ -44,6 +70,25 @@ namespace bloom {
     Shading getShading();
     void setShading(Shading shading);
 
-    virtual void draw() = 0;
+    glm::vec3 getPosition() override;
+    void setPosition(glm::vec3 position) override;
+
+    glm::mat4 getModelMatrix();
+    InstanceData getInstanceData();
+    static InstanceData getInstanceData(const ecs::Transform& transform,
+                                        const ecs::Material& material,
+                                        const ecs::Renderable& renderable);
+
+    // See ecs::Renderable::meshScale
+    glm::vec3 getMeshScale();
+
+    // Geometry shared through the MeshRegistry, objects pointing to the same mesh can be batched
+    // together by the instanced path.
+    bloom::Mesh* getMesh();
+
+    // Level of detail of getMesh() to draw
+    uint32_t getLod();
+
+    void draw();
   };
 }  // namespace bloom
@@ -1,37 +1,54 @@
 #pragma once
 
-#include <bloomCG/buffers/index_buffer.hpp>
-#include <bloomCG/buffers/vertex_array.hpp>
-#include <bloomCG/buffers/vertex_buffer_layout.hpp>
 #include <bloomCG/core/common.hpp>
 #include <bloomCG/core/core.hpp>
 #include <bloomCG/core/shader.hpp>
+#include <bloomCG/models/mesh.hpp>
 #include <bloomCG/models/model.hpp>
 
 namespace bloom {
   class Sphere : public Object {
-  protected:
-    bloom::IndexBuffer* m_indexBuffer;
-    bloom::VertexBufferLayout* m_layoutBuffer;
+  public:
+    // UV: sectors and stacks, every tessellation is its own mesh.
+    // ICOSPHERE: subdivided icosahedron, every level of detail lives in one shared mesh.
+    enum class Type { UV, ICOSPHERE };
 
-  private:
-    std::unique_ptr<bloom::VertexArray> m_vertexArray;
-    std::unique_ptr<bloom::VertexBuffer> m_vertexBuffer;
+    // Levels of the icosphere mesh, level n has 20 * 4^n triangles
+    static constexpr uint8_t ICOSPHERE_LEVELS = 6;
+
+    // Levels of a UV sphere, each one halves the sectors and stacks of the next
+    static constexpr uint8_t UV_LEVELS = 4;
 
   private:
-    static const int MIN_SECTOR_COUNT = 3;
-    static const int MIN_STACK_COUNT = 2;
-    static const int POSITIONS_PER_VERTEX = 3;
-    static const int NORMALS_PER_VERTEX = 3;
+    static constexpr int MIN_SECTOR_COUNT = 3;
+    static constexpr int MIN_STACK_COUNT = 2;
+
+    // Bumped whenever the generators produce different vertices, cached meshes are rebuilt then
+    static constexpr uint32_t MESH_VERSION = 1;
+
+    // 16 bytes instead of 9 floats. Positions of a unit sphere fit normalized shorts (w = 1),
+    // normals fit 10:10:10:2.
+    struct Vertex {
+      std::array<int16_t, 4> position;
+      bloom::Packed1010102 normal;
+      bloom::Packed1010102 faceNormal;
+    };
+    static_assert(sizeof(Vertex) == 16);
 
-    glm::vec3 m_center;
     float m_radius;
     uint16_t m_sectorCount, m_stackCount;
 
-    std::vector<float> m_positions, m_normals, m_averageNormals;
-    std::vector<uint32_t> m_indices;
+    Type m_type = Type::UV;      // As configured
+    Type m_meshType = Type::UV;  // Of m_meshes, behind m_type while a rebuild is pending
+
+    // Unit spheres shared with every other sphere of the same tessellation, the radius is applied
+    // as a scale in the model matrix. One mesh per level for UV spheres, a single mesh holding
+    // every level for icospheres.
+    std::vector<std::shared_ptr<bloom::Mesh>> m_meshes;
 
-    std::vector<float> m_vertexData;  // Combination of (position, normal)
+    // Meshes of the new configuration being generated in the background, m_meshes keeps being
+    // drawn until all of them are uploaded
+    std::vector<std::shared_ptr<bloom::MeshRequest>> m_pending;
 
   public:
     Sphere(glm::vec3 center, glm::vec3 color = glm::vec3{1., .0, .0}, float radius = 0.2,
@@ -42,64 +59,48 @@ namespace bloom {
     constexpr float getRadius() const { return m_radius; }
     constexpr uint16_t getSectorCount() const { return m_sectorCount; }
     constexpr uint16_t getStackCount() const { return m_stackCount; }
+    constexpr Type getType() const { return m_type; }
+
+    // The meshes drawn are still those of the previous configuration
+    inline bool isRebuilding() const { return !m_pending.empty(); }
 
     // Setters
     void set(float radius, uint16_t sectorCount, uint16_t stackCount);
     void setRadius(float radius);
     void setSectorCount(uint16_t sectorCount);
     void setStackCount(uint16_t stackCount);
+    void setType(Type type);
 
-    void setPosition(glm::vec3 position);
-    glm::vec3 getPosition();
+    // ==== Level of detail ====
+    // Levels are ordered from the coarsest, the finest level is the sphere as configured. They
+    // are published in the ecs::Renderable of the sphere, the scene picks the automatic level.
+    uint32_t getLodCount() const;
+    uint8_t getLodLevel();
+    void setLod(uint8_t lod);
+    void setAutoLod(bool enabled);
+    bool isAutoLod();
 
-    // Functionalities
-    void draw();
+    // Triangles not drawn because of the current level
+    uint32_t getTrianglesSaved();
 
     // Debug
     void print();
 
   private:
-    // Private member functions
-    void bindBuffers();
-
-    void buildVertices();
-    void buildVertexData();
-
-    void clearVertex();
-
-    void addPosition(float x, float y, float z);
-    void addNormal(float x, float y, float z);
-    void addAveragedNormal(float x, float y, float z);
-    void addTextureCoordinates(float s, float t);
-
-    // Vertex data
-    uint16_t getPositionCount() const {
-      return (uint16_t)m_positions.size() / Sphere::POSITIONS_PER_VERTEX;
-    }
-    uint16_t getNormalCount() const {
-      return (uint16_t)m_normals.size() / Sphere::NORMALS_PER_VERTEX;
-    }
-    uint16_t getIndexCount() const { return (uint16_t)m_indices.size(); }
-
-    uint16_t getTriangleCount() const { return getIndexCount() / 3; }
-    uint16_t getVertexCount() const { return (uint16_t)m_vertexData.size() / 6; }
-
-    uint16_t getPositionSize() const { return (uint16_t)m_positions.size() * sizeof(float); }
-    uint16_t getNormalSize() const { return (uint16_t)m_normals.size() * sizeof(float); }
-    uint16_t getIndexSize() const { return (uint16_t)m_indices.size() * sizeof(uint16_t); }
-    uint16_t getVertexDataSize() const { return (uint16_t)m_vertexData.size() * sizeof(float); }
+    void acquireMesh();
 
-    const float* getPositions() const { return m_positions.data(); }
-    const float* getNormals() const { return m_normals.data(); }
-    const uint32_t* getIndices() const { return m_indices.data(); }
-    const float* getVertexData() const { return m_vertexData.data(); }
+    // Switch to the pending meshes once they are all uploaded (see MeshRegistry::update), true
+    // when nothing is pending anymore
+    bool swapMeshes();
 
-    // Shift vertex based on new center position
-    void shiftVertex();
+    static Vertex packVertex(const glm::vec3& position, const glm::vec3& faceNormal);
+    static bloom::VertexBufferLayout vertexLayout();
 
-    void addIndices(uint32_t a, uint32_t b, uint32_t c);
+    // Unit sphere geometry for the given tessellation, from the mesh cache when possible. Run on
+    // worker threads, they don't touch the GL.
+    static MeshData generateMesh(uint16_t sectorCount, uint16_t stackCount);
 
-    std::vector<float> computeFaceNormal(float x1, float y1, float z1, float x2, float y2, float z2,
-                                         float x3, float y3, float z3);
+    // Every icosphere level at once, see ICOSPHERE_LEVELS
+    static MeshData generateIcosphereMesh();
   };
 }  // namespace bloom
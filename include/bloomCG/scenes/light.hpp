@@ -1,12 +1,17 @@
 #pragma once
 
 #include <bloomCG/buffers/index_buffer.hpp>
+#include <bloomCG/buffers/stream_buffer.hpp>
+#include <bloomCG/buffers/texture_buffer.hpp>
+#include <bloomCG/buffers/uniform_buffer.hpp>
 #include <bloomCG/buffers/vertex_array.hpp>
 #include <bloomCG/buffers/vertex_buffer.hpp>
 #include <bloomCG/buffers/vertex_buffer_layout.hpp>
 #include <bloomCG/core/camera.hpp>
 #include <bloomCG/core/common.hpp>
 #include <bloomCG/core/core.hpp>
+#include <bloomCG/core/light_clusters.hpp>
+#include <bloomCG/core/render_queue.hpp>
 #include <bloomCG/core/shader.hpp>
 #include <bloomCG/models/cube.hpp>
 #include <bloomCG/models/light.hpp>
@@ -41,22 +46,79 @@ namespace bloom {
       int32_t m_sectorCount = 30;
       int32_t m_stackCount = 30;
 
+      // ==== Per-frame data: camera block (std140, UniformBinding::Camera), instances ====
+      std::unique_ptr<bloom::StreamBuffer> m_streamBuffer;
+
+      // ==== Lights, snapshot once per frame ====
+      glm::vec3 m_ambientIntensity = glm::vec3(0.0f);
+      static constexpr uint32_t POINT_LIGHTS_TEXTURE_SLOT = 0;
+      std::unique_ptr<bloom::TextureBuffer> m_pointLightBuffer;
+      std::vector<bloom::PointLightData> m_pointLights;
+      bool m_hasPointLights = false;
+
+      // ==== Clustered shading ====
+      static constexpr uint32_t CLUSTERS_TEXTURE_SLOT = 1;
+      static constexpr uint32_t CLUSTER_LIGHTS_TEXTURE_SLOT = 2;
+      std::unique_ptr<bloom::LightClusters> m_lightClusters;
+
+      // ==== Update stage ====
+      static constexpr std::size_t LIGHTS_PER_JOB = 512;
+
+      // ==== Render queue ====
+      bloom::RenderQueue m_renderQueue;
+
+      // ==== Level of detail ====
+      uint64_t m_lodTrianglesSaved = 0;  // Last frame
+
+      // ==== Instancing ====
+      bloom::VertexBufferLayout m_instanceLayout;
+
+      // ==== Hierarchy panel ====
+      std::vector<int32_t> m_hierarchyPositions;  // Entity slot -> position in hierarchyEntities
+
     public:
       Light();
+      ~Light();
 
       void onUpdate(const float deltaTime) override;
       void onRender(const float deltaTime) override;
       void onImGuiRender() override;
 
+      // Move the point lights along their orbits at `time`, in parallel
+      void animateLights(const double time);
+
+      void renderInstanced();
+      void drawLightGizmo(const ecs::Transform& transform, ecs::Renderable& renderable);
+      void uploadPointLights();
+      void setLightingUniforms(bloom::Shader* shader);
+
       void inspector();
       void hierarchy();
+
+      // Changes asked from the hierarchy panel, applied once it is drawn since they move entries
+      struct HierarchyEdit {
+        int32_t removed = -1;  // Position in hierarchyEntities
+        bool reparent = false;
+        ecs::EntityID child, parent;
+      };
+
+      // Entry of the hierarchy panel, followed by its children
+      void hierarchyEntry(ecs::EntityID entity, int32_t position, HierarchyEdit& edit);
+
       void addSphere(std::string *name = nullptr, glm::vec3 *position = nullptr,
                      float *radius = nullptr);
       void addCube(std::string *name = nullptr, glm::vec3 *position = nullptr,
                    float *side = nullptr);
+      void addModel();
       void addLight(std::string *name = nullptr, glm::vec3 *position = nullptr);
       void enableGuizmo();
       void guizmoController();
+
+      // Rendering toggles of the UI, for scripted runs (e.g. bench/)
+      Light* setInstancedRendering(bool enabled);
+      Light* setClusteredShading(bool enabled);
+      Light* setOrbitLights(bool enabled);
+      bloom::Camera* getCamera() const;
     };
   }  // namespace scene
 }  // namespace bloom
@@ -15,6 +15,9 @@ namespace bloom {
       virtual void onRender(float deltaTime) {}
       virtual void onImGuiRender() {}
 
+      // Poll the ecs::PendingUpdate components, dropping those done
+      static void updatePending();
+
       float __deltaTime, __lastFrame;
     };
 
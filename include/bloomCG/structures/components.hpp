@@ -0,0 +1,167 @@
+#pragma once
+
+#include <algorithm>
+#include <bloomCG/core/common.hpp>
+#include <bloomCG/structures/registry.hpp>
+
+namespace bloom {
+  class Mesh;
+
+  namespace ecs {
+    enum class Shading { FLAT, GOURAUD, PHONG, BLINN };
+
+    // Scale safe to divide by for normal matrices, axes flattened to zero (e.g. a radius of 0 set
+    // from the UI) would give infinite normals
+    inline glm::vec3 nonZeroScale(const glm::vec3& scale) {
+      constexpr float EPSILON = 1e-6f;
+      glm::vec3 result = scale;
+      for (int axis = 0; axis < 3; axis++)
+        if (std::abs(result[axis]) < EPSILON) result[axis] = std::copysign(EPSILON, result[axis]);
+
+      return result;
+    }
+
+    // Local TRS relative to the parent (the world without one) and the world matrices it yields,
+    // cached until a setter marks them dirty. Rotation in degrees, applied x, y then z.
+    //
+    // World matrices are refreshed by ecs::updateTransforms, which also recomputes the subtree of
+    // every dirty transform. Static content is never recomputed.
+    class Transform {
+    private:
+      glm::vec3 m_position = glm::vec3(0.0f);
+      glm::vec3 m_rotation = glm::vec3(0.0f);
+      glm::vec3 m_scale = glm::vec3(1.0f);
+
+      glm::mat4 m_world = glm::mat4(1.0f);
+      glm::mat3 m_normal = glm::mat3(1.0f);  // Inverse transpose of the world 3x3
+      float m_maxScale = 1.0f;               // Largest world axis scale, for bounding spheres
+      bool m_dirty = true;
+
+    public:
+      // Links of the parenting tree, maintained by ecs::setParent
+      EntityID parent, firstChild, nextSibling;
+
+      inline const glm::vec3& getPosition() const { return m_position; }
+      inline const glm::vec3& getRotation() const { return m_rotation; }
+      inline const glm::vec3& getScale() const { return m_scale; }
+
+      inline Transform& setPosition(const glm::vec3& position) {
+        m_position = position;
+        m_dirty = true;
+        return *this;
+      }
+      inline Transform& setRotation(const glm::vec3& rotation) {
+        m_rotation = rotation;
+        m_dirty = true;
+        return *this;
+      }
+      inline Transform& setScale(const glm::vec3& scale) {
+        m_scale = scale;
+        m_dirty = true;
+        return *this;
+      }
+
+      inline void markDirty() { m_dirty = true; }
+      inline bool isDirty() const { return m_dirty; }
+
+      // As of the last ecs::updateTransforms
+      inline const glm::mat4& getWorldMatrix() const { return m_world; }
+      inline const glm::mat3& getNormalMatrix() const { return m_normal; }
+      inline glm::vec3 getWorldPosition() const { return glm::vec3(m_world[3]); }
+      inline float getMaxScale() const { return m_maxScale; }
+
+      // Rotation and scale, the upper 3x3 of the local matrix
+      inline glm::mat3 getRotationMatrix() const {
+        const glm::vec3 angles = glm::radians(m_rotation);
+        const glm::vec3 c = glm::cos(angles), s = glm::sin(angles);
+
+        const glm::mat3 x(glm::vec3(1.0f, 0.0f, 0.0f), glm::vec3(0.0f, c.x, s.x),
+                          glm::vec3(0.0f, -s.x, c.x));
+        const glm::mat3 y(glm::vec3(c.y, 0.0f, -s.y), glm::vec3(0.0f, 1.0f, 0.0f),
+                          glm::vec3(s.y, 0.0f, c.y));
+        const glm::mat3 z(glm::vec3(c.z, s.z, 0.0f), glm::vec3(-s.z, c.z, 0.0f),
+                          glm::vec3(0.0f, 0.0f, 1.0f));
+        return x * y * z;
+      }
+
+      // Translation, then rotation around x, y and z, then scale
+      inline glm::mat4 getLocalMatrix() const { return getLocalMatrix(getRotationMatrix()); }
+
+      inline glm::mat4 getLocalMatrix(const glm::mat3& rotation) const {
+        return glm::mat4(glm::vec4(rotation[0] * m_scale.x, 0.0f),
+                         glm::vec4(rotation[1] * m_scale.y, 0.0f),
+                         glm::vec4(rotation[2] * m_scale.z, 0.0f), glm::vec4(m_position, 1.0f));
+      }
+
+      // The normal matrix of a rotation and scale is the rotation over the scale, so it is
+      // chained from the parent one without inverting anything.
+      inline void updateWorld(const glm::mat4& parentWorld, const glm::mat3& parentNormal) {
+        const glm::mat3 rotation = getRotationMatrix();
+        const glm::vec3 scale = nonZeroScale(m_scale);
+
+        m_world = parentWorld * getLocalMatrix(rotation);
+        m_normal = parentNormal
+                   * glm::mat3(rotation[0] / scale.x, rotation[1] / scale.y,
+                               rotation[2] / scale.z);
+        m_maxScale = std::max({glm::length(glm::vec3(m_world[0])),
+                               glm::length(glm::vec3(m_world[1])),
+                               glm::length(glm::vec3(m_world[2]))});
+        m_dirty = false;
+      }
+    };
+
+    struct Material {
+      glm::vec3 ka = glm::vec3(1.0f);
+      glm::vec3 kd = glm::vec3(1.0f);
+      glm::vec3 ks = glm::vec3(.5f);
+      float shininess = 32.0f;
+      Shading shading = Shading::PHONG;
+    };
+
+    // Geometry drawn for an entity, meshes are owned by the object that set them (see
+    // MeshRegistry). Levels of detail go from the coarsest to the finest, each one a mesh and the
+    // LOD of that mesh to draw.
+    struct Renderable {
+      static constexpr uint32_t MAX_LEVELS = 8;
+
+      struct Level {
+        bloom::Mesh* mesh = nullptr;
+        uint32_t lod = 0;
+      };
+
+      std::array<Level, MAX_LEVELS> levels{};
+      uint8_t levelCount = 0;
+      uint8_t level = 0;     // Drawn
+      bool autoLod = false;  // Level picked from the size on screen every frame
+
+      // Scale baked in the model matrix on top of the transform one, lets entities share a
+      // normalized mesh (e.g. the unit sphere) while keeping their own dimensions.
+      glm::vec3 meshScale = glm::vec3(1.0f);
+      float boundingRadius = 1.0f;  // Of the normalized mesh
+
+      inline const Level& getLevel() const { return levels[level]; }
+    };
+
+    struct Visibility {
+      bool visible = true;
+    };
+
+    struct AmbientLight {
+      glm::vec3 intensity = glm::vec3(.2f);
+    };
+
+    // Positioned by the Transform of the entity
+    struct PointLight {
+      glm::vec3 intensity = glm::vec3(1.0f);
+      float constant = 1.0f;
+      float linear = .09f;
+      float quadratic = .032f;
+    };
+
+    // Polled every frame until it returns true, then removed. For entities waiting on work done
+    // elsewhere, e.g. meshes generated in the background.
+    struct PendingUpdate {
+      std::function<bool()> poll;
+    };
+  }  // namespace ecs
+}  // namespace bloom
@@ -3,92 +3,117 @@
 #include <bloomCG/core/camera.hpp>
 #include <bloomCG/core/common.hpp>
 #include <bloomCG/models/cube.hpp>
+#include <bloomCG/models/imported_model.hpp>
 #include <bloomCG/models/light.hpp>
 #include <bloomCG/models/sphere.hpp>
+#include <bloomCG/structures/registry.hpp>
+#include <bloomCG/structures/transform_system.hpp>
+#include <bloomCG/utils/span.hpp>
 
 namespace bloom {
 
   // Each key represents the type of the constructor of the class
-  enum class ObjectType { CUBE, SPHERE, AMBIENT_LIGHT, POINT_LIGHT, CAMERA };
-  struct Objects {
-    ObjectType type;
+  enum class ObjectType { CUBE, SPHERE, MODEL, AMBIENT_LIGHT, POINT_LIGHT, CAMERA };
+  constexpr std::size_t OBJECT_TYPE_COUNT = (std::size_t)ObjectType::CAMERA + 1;
+
+  // Component of the entities listed in the hierarchy, which owns their object: destroying the
+  // entity deletes it.
+  struct HierarchyNode {
     std::string name;
-    int32_t index;
-
-    union Object {
-      bloom::Sphere* sphere;
-      bloom::Cube* cube;
-      bloom::AmbientLight* ambientLight;
-      bloom::PointLight* pointLight;
-      bloom::Camera* camera;
-    } object;
-
-    // The variables from below are not necessary in the default constructor
-    bool visible;
-
-    Objects(ObjectType type, const std::string& name, int32_t index, Object object,
-            bool is_visible = true)
-        : type(type), name(name), index(index), object(object), visible(is_visible) {}
-
-    // Create a empty constructor for non-pointer types
-    Objects() {}
-
-    bloom::Entity* get() {
-      // Check for the current type of the struct, then return the object
-      switch (type) {
-        case ObjectType::CUBE:
-          return object.cube;
-        case ObjectType::SPHERE:
-          return object.sphere;
-        case ObjectType::AMBIENT_LIGHT:
-          return object.ambientLight;
-        case ObjectType::POINT_LIGHT:
-          return (bloom::Object*)object.pointLight;
-        case ObjectType::CAMERA:
-          return object.camera;
-      }
-
-      return nullptr;
-    }
+    ObjectType type;
+    int32_t index;  // Among the objects of the same type, in creation order
+    std::unique_ptr<bloom::Entity> object;
+    uint32_t typePosition = 0;  // In hierarchyByType
   };
 
-  inline std::ostream& operator<<(std::ostream& os, const Objects& object) {
-    os << "Object: " << object.name << " (" << object.index << ")";
+  inline std::ostream& operator<<(std::ostream& os, const HierarchyNode& node) {
+    os << "Object: " << node.name << " (" << node.index << ")";
     return os;
   }
 
-  // Hierarchy
-  std::vector<Objects> hierarchyObjects;
-
-  // Get reference of the object by type
-  template <ObjectType T> Objects& getObjectByTypeRef(int32_t index) {
-    // Retrieve the index of the object in the hierarchy that matches the type and index
-    std::for_each(hierarchyObjects.begin(), hierarchyObjects.end(),
-                  [&index](const Objects& object) {
-                    if (object.type == T && object.index == index) {
-                      index = object.index;
-                    }
-                  });
-
-    // Return the object
-    return hierarchyObjects[index];
+  // Hierarchy, in display order
+  inline std::vector<ecs::EntityID> hierarchyEntities;
+
+  // Entities of each type, in no particular order. Updated as entities are added and removed, so
+  // typed queries never walk the whole hierarchy.
+  inline std::array<std::vector<ecs::EntityID>, OBJECT_TYPE_COUNT> hierarchyByType;
+
+  inline HierarchyNode& getNode(ecs::EntityID entity) {
+    return ecs::registry.get<HierarchyNode>(entity);
+  }
+
+  // Invalidated by the next addition or removal of that type
+  inline Span<const ecs::EntityID> getObjectsByType(ObjectType type) {
+    const auto& entities = hierarchyByType[(std::size_t)type];
+    return {entities.data(), entities.size()};
+  }
+
+  inline uint32_t countObjects(ObjectType type) {
+    return hierarchyByType[(std::size_t)type].size();
   }
 
-  // Get all objects of the hierarchy by type, if index is informed, it will get the object at the
-  // index of the vector
-  template <ObjectType T> std::vector<Objects> getObjectByType() {
-    std::vector<Objects> objects;
-    std::copy_if(hierarchyObjects.begin(), hierarchyObjects.end(), std::back_inserter(objects),
-                 [](const Objects& obj) { return obj.type == T; });
-    return objects;
+  inline bool hasObjectNamed(const std::string& name) {
+    auto& nodes = ecs::registry.pool<HierarchyNode>();
+    return std::any_of(nodes.begin(), nodes.end(),
+                       [&name](const HierarchyNode& node) { return node.name == name; });
   }
 
-  template <ObjectType T> Objects getObjectByType(int32_t index) {
-    std::vector<Objects> objects = getObjectByType<T>();
+  // Hand the object over to the hierarchy, at the end of it
+  inline ecs::EntityID addToHierarchy(ObjectType type, const std::string& name,
+                                      bloom::Entity* object, bool visible = true) {
+    const ecs::EntityID entity = object->getEntityID();
+    auto& typed = hierarchyByType[(std::size_t)type];
+
+    ecs::registry.emplace<HierarchyNode>(entity, name, type, (int32_t)typed.size(),
+                                         std::unique_ptr<bloom::Entity>(object),
+                                         (uint32_t)typed.size());
+    ecs::registry.emplace<ecs::Visibility>(entity, visible);
+    hierarchyEntities.push_back(entity);
+    typed.push_back(entity);
+
+    return entity;
+  }
+
+  // Destroy an entity of the hierarchy, and its object. It must also leave hierarchyEntities.
+  inline void destroyHierarchyEntity(ecs::EntityID entity) {
+    const HierarchyNode& node = getNode(entity);
+    auto& typed = hierarchyByType[(std::size_t)node.type];
+
+    // The last entity of the type takes its place
+    const uint32_t position = node.typePosition;
+    typed[position] = typed.back();
+    getNode(typed[position]).typePosition = position;
+    typed.pop_back();
+
+    ecs::detach(entity);
+    ecs::registry.destroy(entity);
+  }
+
+  // Destroy the entity at `position` in the hierarchy
+  inline void removeFromHierarchy(std::size_t position) {
+    const ecs::EntityID entity = hierarchyEntities[position];
+    hierarchyEntities.erase(hierarchyEntities.begin() + position);
+    destroyHierarchyEntity(entity);
+  }
+
+  // Destroy the entities `remove` returns true for, in one pass
+  inline void removeFromHierarchyIf(const std::function<bool(const HierarchyNode&)>& remove) {
+    std::vector<ecs::EntityID> entities;
+    entities.swap(hierarchyEntities);
+
+    for (ecs::EntityID entity : entities) {
+      if (remove(getNode(entity)))
+        destroyHierarchyEntity(entity);
+      else
+        hierarchyEntities.push_back(entity);
+    }
+  }
 
-    if (objects.size() == 0) return Objects{};
+  inline void clearHierarchy() {
+    for (ecs::EntityID entity : hierarchyEntities) ecs::registry.destroy(entity);
+    hierarchyEntities.clear();
 
-    return objects[index];
+    for (auto& typed : hierarchyByType) typed.clear();
   }
 
 }  // namespace bloom
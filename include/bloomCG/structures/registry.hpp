@@ -0,0 +1,175 @@
+#pragma once
+
+#include <bloomCG/core/common.hpp>
+
+namespace bloom {
+  namespace ecs {
+    // Stable handle to an entity: its slot and the generation of the slot when it was created.
+    // Slots are reused once destroyed, handles to the previous entity never match again.
+    struct EntityID {
+      uint32_t index = UINT32_MAX;
+      uint32_t generation = 0;
+
+      inline bool isNull() const { return index == UINT32_MAX; }
+      inline bool operator==(const EntityID& other) const {
+        return index == other.index && generation == other.generation;
+      }
+      inline bool operator!=(const EntityID& other) const { return !(*this == other); }
+    };
+
+    class BasePool {
+    public:
+      virtual ~BasePool() {}
+
+      virtual bool has(EntityID entity) const = 0;
+      virtual void remove(EntityID entity) = 0;
+      virtual void clear() = 0;
+    };
+
+    // Sparse set: components are packed in a dense array, in no particular order, next to the
+    // entity owning each of them. Entity slots index a sparse array pointing into the dense one,
+    // so lookups are O(1) and removing swaps the last component in the hole.
+    template <typename T> class ComponentPool : public BasePool {
+    private:
+      static constexpr uint32_t INVALID = UINT32_MAX;
+
+      std::vector<uint32_t> m_sparse;    // Entity slot -> dense index
+      std::vector<EntityID> m_entities;  // Dense
+      std::vector<T> m_components;       // Dense
+
+    public:
+      bool has(EntityID entity) const override {
+        return entity.index < m_sparse.size() && m_sparse[entity.index] != INVALID
+               && m_entities[m_sparse[entity.index]] == entity;
+      }
+
+      // Replaces the component when the entity already has one
+      template <typename... Args> T& emplace(EntityID entity, Args&&... args) {
+        if (has(entity)) return get(entity) = T{std::forward<Args>(args)...};
+
+        if (entity.index >= m_sparse.size()) m_sparse.resize(entity.index + 1, INVALID);
+
+        m_sparse[entity.index] = m_components.size();
+        m_entities.push_back(entity);
+        return m_components.emplace_back(T{std::forward<Args>(args)...});
+      }
+
+      void remove(EntityID entity) override {
+        if (!has(entity)) return;
+
+        const uint32_t index = m_sparse[entity.index];
+        const uint32_t last = m_components.size() - 1;
+
+        // The entity is detached before its component is destroyed, which may run arbitrary code
+        [[maybe_unused]] T component = std::move(m_components[index]);
+        m_sparse[entity.index] = INVALID;
+
+        if (index != last) {
+          m_components[index] = std::move(m_components[last]);
+          m_entities[index] = m_entities[last];
+          m_sparse[m_entities[index].index] = index;
+        }
+
+        m_components.pop_back();
+        m_entities.pop_back();
+      }
+
+      void clear() override {
+        std::vector<T> components;
+        components.swap(m_components);
+
+        m_sparse.clear();
+        m_entities.clear();
+      }
+
+      inline T& get(EntityID entity) { return m_components[m_sparse[entity.index]]; }
+      inline T* tryGet(EntityID entity) { return has(entity) ? &get(entity) : nullptr; }
+
+      // Dense access, for passes walking every component of the type
+      inline std::size_t size() const { return m_components.size(); }
+      inline T& operator[](std::size_t index) { return m_components[index]; }
+      inline EntityID getEntity(std::size_t index) const { return m_entities[index]; }
+
+      inline typename std::vector<T>::iterator begin() { return m_components.begin(); }
+      inline typename std::vector<T>::iterator end() { return m_components.end(); }
+    };
+
+    // Entities are plain handles, their data lives in one ComponentPool per component type. Main
+    // thread only: creating or destroying entities and components is not synchronized.
+    class Registry {
+    private:
+      struct Slot {
+        uint32_t generation = 0;
+        bool alive = false;
+      };
+
+      std::vector<Slot> m_slots;
+      std::vector<uint32_t> m_free;
+      std::vector<std::unique_ptr<BasePool>> m_pools;  // Indexed by component type
+      uint32_t m_alive = 0;
+
+      static inline uint32_t s_typeCount = 0;
+
+      template <typename T> static uint32_t typeIndex() {
+        static const uint32_t index = s_typeCount++;
+        return index;
+      }
+
+    public:
+      Registry() {}
+      ~Registry();
+
+      Registry(const Registry&) = delete;
+      Registry& operator=(const Registry&) = delete;
+
+      EntityID create();
+
+      // Removes every component of the entity. The handle is invalidated first, so components
+      // destroyed along (e.g. an owned object) see the entity as dead already.
+      void destroy(EntityID entity);
+
+      // Destroy every entity
+      void clear();
+
+      inline bool isAlive(EntityID entity) const {
+        return entity.index < m_slots.size() && m_slots[entity.index].alive
+               && m_slots[entity.index].generation == entity.generation;
+      }
+
+      inline uint32_t size() const { return m_alive; }
+
+      template <typename T> ComponentPool<T>& pool() {
+        const uint32_t index = typeIndex<T>();
+        if (index >= m_pools.size()) m_pools.resize(index + 1);
+        if (!m_pools[index]) m_pools[index] = std::make_unique<ComponentPool<T>>();
+
+        return *static_cast<ComponentPool<T>*>(m_pools[index].get());
+      }
+
+      template <typename T, typename... Args> T& emplace(EntityID entity, Args&&... args) {
+        return pool<T>().emplace(entity, std::forward<Args>(args)...);
+      }
+
+      template <typename T> void remove(EntityID entity) { pool<T>().remove(entity); }
+      template <typename T> bool has(EntityID entity) { return pool<T>().has(entity); }
+      template <typename T> T& get(EntityID entity) { return pool<T>().get(entity); }
+      template <typename T> T* tryGet(EntityID entity) { return pool<T>().tryGet(entity); }
+
+      // Call `function(entity, T&, Others&...)` for every entity having all the components,
+      // walking the dense array of T. It must not add or remove components of T.
+      template <typename T, typename... Others, typename Function> void each(Function&& function) {
+        ComponentPool<T>& components = pool<T>();
+
+        for (std::size_t i = 0; i < components.size(); i++) {
+          const EntityID entity = components.getEntity(i);
+          if (!(has<Others>(entity) && ...)) continue;
+
+          function(entity, components[i], get<Others>(entity)...);
+        }
+      }
+    };
+
+    // Entities of the running scene
+    inline Registry registry;
+  }  // namespace ecs
+}  // namespace bloom
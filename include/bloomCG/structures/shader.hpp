@@ -1,11 +1,18 @@
 #pragma once
 
+#include <bloomCG/buffers/uniform_buffer.hpp>
 #include <bloomCG/core/common.hpp>
 #include <bloomCG/core/shader.hpp>
 #include <functional>
 
 namespace bloom {
-  enum class ShaderType { Object = 3, Light = 4 };
+  enum class ShaderType {
+    Object = 3,
+    Light = 4,
+    InstancedObject = 5,
+    ClusteredObject = 6,
+    InstancedClusteredObject = 7
+  };
   enum class LightModel { Flat, Gouraud, Phong };
 
   typedef std::pair<ShaderType, LightModel> Name;
@@ -26,8 +33,11 @@ namespace bloom {
     }
 
     template <ShaderType Type, LightModel Model = LightModel::Phong>
-    ShaderMap* registerShader(const std::string& path) {
-      shaders[Name(Type, Model)] = new bloom::Shader(path);
+    ShaderMap* registerShader(const std::string& path,
+                              const std::vector<std::string>& defines = {}) {
+      shaders[Name(Type, Model)] = (new bloom::Shader(path, defines))
+                                       ->setUniformBlockBinding("Camera",
+                                                                (uint32_t)UniformBinding::Camera);
       return this;
     }
   };
@@ -0,0 +1,26 @@
+#pragma once
+
+#include <bloomCG/structures/components.hpp>
+#include <bloomCG/structures/registry.hpp>
+
+namespace bloom {
+  namespace ecs {
+    // Attach `child` under `parent`, or make it a root with a null parent. The local transform is
+    // kept, it becomes relative to the new parent. False when it would create a cycle.
+    bool setParent(EntityID child, EntityID parent);
+
+    // Whether `entity` is `ancestor` or somewhere below it
+    bool isDescendant(EntityID entity, EntityID ancestor);
+
+    // Take the entity out of the tree before it is destroyed, its children become roots
+    void detach(EntityID entity);
+
+    // Move the entity to a world position, through the inverse of its parent's world matrix
+    void setWorldPosition(EntityID entity, const glm::vec3& position);
+
+    // Recompute the world matrices of the dirty transforms and of everything below them, parents
+    // first. Once a frame, after the transforms were animated and before they are drawn. Roots
+    // are split across the job system, each job walking the subtrees of its own.
+    void updateTransforms();
+  }  // namespace ecs
+}  // namespace bloom
@@ -0,0 +1,27 @@
+#pragma once
+
+#include <cstddef>
+
+namespace bloom {
+  // Non-owning view over contiguous elements (std::span is C++20). Valid as long as the storage
+  // it points into is not resized.
+  template <typename T> class Span {
+  private:
+    T* m_data = nullptr;
+    std::size_t m_size = 0;
+
+  public:
+    constexpr Span() {}
+    constexpr Span(T* data, std::size_t size) : m_data(data), m_size(size) {}
+
+    constexpr T* begin() const { return m_data; }
+    constexpr T* end() const { return m_data + m_size; }
+    constexpr T* data() const { return m_data; }
+
+    constexpr std::size_t size() const { return m_size; }
+    constexpr bool empty() const { return m_size == 0; }
+
+    constexpr T& operator[](std::size_t index) const { return m_data[index]; }
+    constexpr T& front() const { return m_data[0]; }
+  };
+}  // namespace bloom
@@ -0,0 +1,161 @@
+#include <bloomCG/buffers/stream_buffer.hpp>
+#include <bloomCG/core/core.hpp>
+#include <bloomCG/core/profiler.hpp>
+
+// ARB_buffer_storage tokens, in case the loader was generated for an older GL
+#ifndef GL_MAP_PERSISTENT_BIT
+#  define GL_MAP_PERSISTENT_BIT 0x0040
+#endif
+#ifndef GL_MAP_COHERENT_BIT
+#  define GL_MAP_COHERENT_BIT 0x0080
+#endif
+
+namespace bloom {
+  typedef void(APIENTRY* BufferStorageProc)(GLenum target, GLsizeiptr size, const void* data,
+                                            GLbitfield flags);
+
+  // Resolved by hand like glDebugMessageCallback (see core.cpp), null when not supported
+  static BufferStorageProc bufferStorage() {
+    static const BufferStorageProc proc = []() -> BufferStorageProc {
+      GLint major = 0, minor = 0;
+      GLCall(glad_glGetIntegerv(GL_MAJOR_VERSION, &major));
+      GLCall(glad_glGetIntegerv(GL_MINOR_VERSION, &minor));
+
+      const bool supported
+          = major * 10 + minor >= 44 || glfwExtensionSupported("GL_ARB_buffer_storage");
+      return supported ? (BufferStorageProc)glfwGetProcAddress("glBufferStorage") : nullptr;
+    }();
+
+    return proc;
+  }
+
+  StreamBuffer::StreamBuffer(uint32_t regionSize, uint32_t regionCount)
+      : m_regionSize(regionSize), m_regionCount(regionCount), m_fences(regionCount, nullptr) {
+    GLint alignment = 256;
+    GLCall(glad_glGetIntegerv(GL_UNIFORM_BUFFER_OFFSET_ALIGNMENT, &alignment));
+    m_uniformAlignment = alignment;
+
+    // Every region starts aligned for uniform blocks
+    m_regionSize
+        = (m_regionSize + m_uniformAlignment - 1) / m_uniformAlignment * m_uniformAlignment;
+
+    m_persistent = bufferStorage() != nullptr;
+    create();
+  }
+
+  StreamBuffer::~StreamBuffer() {
+    releaseRetired();
+    destroy();
+  }
+
+  void StreamBuffer::create() {
+    const uint32_t size = m_regionSize * m_regionCount;
+
+    // Bound to the copy target, so vertex and uniform bindings are left alone
+    GLCall(glad_glGenBuffers(1, &m_rendererID));
+    GLCall(glad_glBindBuffer(GL_COPY_WRITE_BUFFER, m_rendererID));
+
+    if (m_persistent) {
+      const GLbitfield flags = GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT;
+      GLCall(bufferStorage()(GL_COPY_WRITE_BUFFER, size, nullptr, flags));
+      GLCall(m_mapping = (char*)glad_glMapBufferRange(GL_COPY_WRITE_BUFFER, 0, size, flags));
+    } else {
+      GLCall(glad_glBufferData(GL_COPY_WRITE_BUFFER, size, nullptr, GL_STREAM_DRAW));
+      m_copy.assign(size, 0);
+      m_mapping = m_copy.data();
+    }
+
+    GLCall(glad_glBindBuffer(GL_COPY_WRITE_BUFFER, 0));
+  }
+
+  void StreamBuffer::deleteFences() {
+    for (GLsync& fence : m_fences) {
+      if (!fence) continue;
+
+      GLCall(glad_glDeleteSync(fence));
+      fence = nullptr;
+    }
+  }
+
+  void StreamBuffer::destroy() {
+    deleteFences();
+
+    // Draws still reading the buffer keep its storage alive, the driver frees it after them
+    GLCall(glad_glDeleteBuffers(1, &m_rendererID));
+    m_mapping = nullptr;
+  }
+
+  void StreamBuffer::releaseRetired() {
+    for (uint32_t& rendererID : m_retired) {
+      GLCall(glad_glDeleteBuffers(1, &rendererID));
+    }
+    m_retired.clear();
+    m_retiredCopies.clear();
+  }
+
+  void StreamBuffer::beginFrame() {
+    m_region = (m_region + 1) % m_regionCount;
+    m_head = m_flushed = 0;
+
+    GLsync& fence = m_fences[m_region];
+    if (!fence) return;
+
+    // Only blocks when the CPU is FRAMES_IN_FLIGHT frames ahead of the GPU
+    BLOOM_PROFILE_SCOPE("Stream buffer wait");
+    GLenum status = GL_TIMEOUT_EXPIRED;
+    while (status == GL_TIMEOUT_EXPIRED) {
+      GLCall(status = glad_glClientWaitSync(fence, GL_SYNC_FLUSH_COMMANDS_BIT, 1000000000));
+    }
+
+    GLCall(glad_glDeleteSync(fence));
+    fence = nullptr;
+  }
+
+  void StreamBuffer::endFrame() {
+    flush();
+
+    // Every draw of the frame is submitted, the driver keeps the storage alive until they're done
+    releaseRetired();
+
+    GLCall(m_fences[m_region] = glad_glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0));
+  }
+
+  StreamAllocation StreamBuffer::allocate(uint32_t size, uint32_t alignment) {
+    uint32_t offset = (m_head + alignment - 1) / alignment * alignment;
+
+    if (offset + size > m_regionSize) {
+      // Grow for the next frames. The old buffer is kept until endFrame, the ranges of this frame
+      // (e.g. the camera uniform block) are still bound from it. Its pending fences protect
+      // regions nothing will write again.
+      flush();
+      m_retired.push_back(m_rendererID);
+      m_retiredCopies.push_back(std::move(m_copy));
+      deleteFences();
+
+      while (m_regionSize < size) m_regionSize *= 2;
+      m_regionSize *= 2;
+      m_region = 0;
+      create();
+
+      offset = 0;
+      m_head = m_flushed = 0;
+    }
+
+    m_head = offset + size;
+
+    const uint32_t base = m_region * m_regionSize;
+    return {m_mapping + base + offset, m_rendererID, base + offset, size};
+  }
+
+  void StreamBuffer::flush() {
+    if (m_persistent || m_flushed == m_head) return;
+
+    const uint32_t base = m_region * m_regionSize;
+    GLCall(glad_glBindBuffer(GL_COPY_WRITE_BUFFER, m_rendererID));
+    GLCall(glad_glBufferSubData(GL_COPY_WRITE_BUFFER, base + m_flushed, m_head - m_flushed,
+                                m_mapping + base + m_flushed));
+    GLCall(glad_glBindBuffer(GL_COPY_WRITE_BUFFER, 0));
+
+    m_flushed = m_head;
+  }
+}  // namespace bloom
@@ -0,0 +1,44 @@
+#include <bloomCG/buffers/texture_buffer.hpp>
+#include <bloomCG/core/core.hpp>
+
+namespace bloom {
+  TextureBuffer::TextureBuffer(uint32_t size, uint32_t internalFormat, uint32_t usage)
+      : m_size(size), m_usage(usage) {
+    GLCall(glad_glGenBuffers(1, &m_bufferID));
+    GLCall(glad_glBindBuffer(GL_TEXTURE_BUFFER, m_bufferID));
+    GLCall(glad_glBufferData(GL_TEXTURE_BUFFER, size, nullptr, usage));
+    GLCall(glad_glBindBuffer(GL_TEXTURE_BUFFER, 0));
+
+    // The texture is only a view over the buffer, it survives reallocations of the storage
+    GLCall(glad_glGenTextures(1, &m_textureID));
+    GLCall(glad_glBindTexture(GL_TEXTURE_BUFFER, m_textureID));
+    GLCall(glad_glTexBuffer(GL_TEXTURE_BUFFER, internalFormat, m_bufferID));
+    GLCall(glad_glBindTexture(GL_TEXTURE_BUFFER, 0));
+  }
+
+  TextureBuffer::~TextureBuffer() {
+    GLCall(glad_glDeleteTextures(1, &m_textureID));
+    GLCall(glad_glDeleteBuffers(1, &m_bufferID));
+  }
+
+  void TextureBuffer::bind(uint32_t slot) const {
+    GLCall(glad_glActiveTexture(GL_TEXTURE0 + slot));
+    GLCall(glad_glBindTexture(GL_TEXTURE_BUFFER, m_textureID));
+  }
+
+  void TextureBuffer::unbind(uint32_t slot) const {
+    GLCall(glad_glActiveTexture(GL_TEXTURE0 + slot));
+    GLCall(glad_glBindTexture(GL_TEXTURE_BUFFER, 0));
+  }
+
+  void TextureBuffer::setData(const void* data, uint32_t size) {
+    GLCall(glad_glBindBuffer(GL_TEXTURE_BUFFER, m_bufferID));
+
+    if (size > m_size) m_size = std::max(size, m_size * 2);
+
+    // Orphan the previous storage so we don't wait on draws still reading last frame's data
+    GLCall(glad_glBufferData(GL_TEXTURE_BUFFER, m_size, nullptr, m_usage));
+    GLCall(glad_glBufferSubData(GL_TEXTURE_BUFFER, 0, size, data));
+    GLCall(glad_glBindBuffer(GL_TEXTURE_BUFFER, 0));
+  }
+}  // namespace bloom
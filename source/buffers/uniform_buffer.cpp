@@ -0,0 +1,8 @@
+#include <bloomCG/buffers/uniform_buffer.hpp>
+#include <bloomCG/core/core.hpp>
+
+namespace bloom {
+  void bindUniformRange(UniformBinding binding, uint32_t buffer, uint32_t offset, uint32_t size) {
+    GLCall(glad_glBindBufferRange(GL_UNIFORM_BUFFER, (uint32_t)binding, buffer, offset, size));
+  }
+}  // namespace bloom
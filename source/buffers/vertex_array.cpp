@@ -40,7 +40,32 @@ namespace bloom {
       GLCall(glad_glVertexAttribPointer(i, element.count, element.type, element.normalized,
                                         layout.getStride(), (const void *)(intptr_t)offset));
 
-      offset += element.count * VertexBufferLayoutElement::getSizeOfType(element.type);
+      offset += element.getSize();
+    }
+  }
+
+  void VertexArray::addInstanceBuffer(const VertexBuffer &buffer, const VertexBufferLayout &layout,
+                                      uint32_t firstAttribute) {
+    addInstanceBuffer(buffer.getRendererID(), 0, layout, firstAttribute);
+  }
+
+  void VertexArray::addInstanceBuffer(uint32_t buffer, uint32_t offset,
+                                      const VertexBufferLayout &layout, uint32_t firstAttribute) {
+    this->bind();
+    GLCall(glad_glBindBuffer(GL_ARRAY_BUFFER, buffer));
+
+    const auto &elements = layout.getElements();
+
+    for (uint32_t i = 0; i < elements.size(); i++) {
+      const auto &element = elements[i];
+      const uint32_t attribute = firstAttribute + i;
+
+      GLCall(glad_glEnableVertexAttribArray(attribute));
+      GLCall(glad_glVertexAttribPointer(attribute, element.count, element.type, element.normalized,
+                                        layout.getStride(), (const void *)(intptr_t)offset));
+      GLCall(glad_glVertexAttribDivisor(attribute, 1));
+
+      offset += element.getSize();
     }
   }
 }  // namespace bloom
@@ -2,10 +2,11 @@
 #include <bloomCG/core/core.hpp>
 
 namespace bloom {
-  VertexBuffer::VertexBuffer(const void* data, uint32_t size) {
+  VertexBuffer::VertexBuffer(const void* data, uint32_t size, uint32_t usage)
+      : m_size(size), m_usage(usage) {
     GLCall(glad_glGenBuffers(1, &m_rendererID));
     GLCall(glad_glBindBuffer(GL_ARRAY_BUFFER, m_rendererID));
-    GLCall(glad_glBufferData(GL_ARRAY_BUFFER, size, data, GL_STATIC_DRAW));
+    GLCall(glad_glBufferData(GL_ARRAY_BUFFER, size, data, usage));
   }
 
   VertexBuffer::~VertexBuffer() { GLCall(glad_glDeleteBuffers(1, &m_rendererID)); }
@@ -13,4 +14,16 @@ namespace bloom {
   void VertexBuffer::bind() const { GLCall(glad_glBindBuffer(GL_ARRAY_BUFFER, m_rendererID)); }
 
   void VertexBuffer::unbind() const { GLCall(glad_glBindBuffer(GL_ARRAY_BUFFER, 0)); }
+
+  void VertexBuffer::setData(const void* data, uint32_t size) {
+    bind();
+
+    // Grow geometrically so a slowly increasing instance count doesn't reallocate every frame
+    if (size > m_size) m_size = std::max(size, m_size * 2);
+
+    // Orphan the previous storage, the driver hands us a fresh block instead of stalling on draws
+    // that may still be reading from the old one.
+    GLCall(glad_glBufferData(GL_ARRAY_BUFFER, m_size, nullptr, m_usage));
+    GLCall(glad_glBufferSubData(GL_ARRAY_BUFFER, 0, size, data));
+  }
 }  // namespace bloom
@@ -3,28 +3,81 @@
 
 namespace bloom {
 
-  template <typename T> VertexBufferLayout& VertexBufferLayout::push(uint32_t count) {
+  template <typename T>
+  VertexBufferLayout& VertexBufferLayout::push(uint32_t count, bool normalized) {
     ASSERT(false);
     return *this;
   }
 
-  template <> VertexBufferLayout& VertexBufferLayout::push<float>(uint32_t count) {
+  VertexBufferLayout& VertexBufferLayout::push(const VertexBufferLayoutElement& element) {
+    m_elements.push_back(element);
+    m_stride += element.getSize();
+
+    return *this;
+  }
+
+  template <> VertexBufferLayout& VertexBufferLayout::push<float>(uint32_t count, bool normalized) {
+    ASSERT(!normalized);  // Only integer types are normalized
     m_elements.push_back({GL_FLOAT, count, GL_FALSE});
-    m_stride += count * VertexBufferLayoutElement::getSizeOfType(GL_FLOAT);
+    m_stride += m_elements.back().getSize();
 
     return *this;
   }
 
-  template <> VertexBufferLayout& VertexBufferLayout::push<uint32_t>(uint32_t count) {
-    m_elements.push_back({GL_UNSIGNED_INT, count, GL_FALSE});
-    m_stride += count * VertexBufferLayoutElement::getSizeOfType(GL_UNSIGNED_INT);
+  template <>
+  VertexBufferLayout& VertexBufferLayout::push<uint32_t>(uint32_t count, bool normalized) {
+    m_elements.push_back({GL_UNSIGNED_INT, count, (uint32_t)normalized});
+    m_stride += m_elements.back().getSize();
 
     return *this;
   }
 
-  template <> VertexBufferLayout& VertexBufferLayout::push<uint8_t>(uint32_t count) {
-    m_elements.push_back({GL_FLOAT, count, GL_FALSE});
-    m_stride += count * VertexBufferLayoutElement::getSizeOfType(GL_UNSIGNED_BYTE);
+  template <>
+  VertexBufferLayout& VertexBufferLayout::push<uint16_t>(uint32_t count, bool normalized) {
+    m_elements.push_back({GL_UNSIGNED_SHORT, count, (uint32_t)normalized});
+    m_stride += m_elements.back().getSize();
+
+    return *this;
+  }
+
+  template <>
+  VertexBufferLayout& VertexBufferLayout::push<int16_t>(uint32_t count, bool normalized) {
+    m_elements.push_back({GL_SHORT, count, (uint32_t)normalized});
+    m_stride += m_elements.back().getSize();
+
+    return *this;
+  }
+
+  template <>
+  VertexBufferLayout& VertexBufferLayout::push<uint8_t>(uint32_t count, bool normalized) {
+    m_elements.push_back({GL_UNSIGNED_BYTE, count, (uint32_t)normalized});
+    m_stride += m_elements.back().getSize();
+
+    return *this;
+  }
+
+  template <>
+  VertexBufferLayout& VertexBufferLayout::push<int8_t>(uint32_t count, bool normalized) {
+    m_elements.push_back({GL_BYTE, count, (uint32_t)normalized});
+    m_stride += m_elements.back().getSize();
+
+    return *this;
+  }
+
+  template <> VertexBufferLayout& VertexBufferLayout::push<Half>(uint32_t count, bool normalized) {
+    ASSERT(!normalized);  // Only integer types are normalized
+    m_elements.push_back({GL_HALF_FLOAT, count, GL_FALSE});
+    m_stride += m_elements.back().getSize();
+
+    return *this;
+  }
+
+  // `count` is the number of components read by the shader, GL only accepts 4 for packed types
+  template <>
+  VertexBufferLayout& VertexBufferLayout::push<Packed1010102>(uint32_t count, bool normalized) {
+    ASSERT(count == 4);
+    m_elements.push_back({GL_INT_2_10_10_10_REV, count, (uint32_t)normalized});
+    m_stride += m_elements.back().getSize();
 
     return *this;
   }
@@ -77,6 +77,11 @@ namespace bloom {
 
   glm::mat4 Camera::getViewportMatrix() const { return m_viewportMatrix; }
 
+  CameraUniformBlock Camera::getUniformBlock() const {
+    return {getViewMatrix(), getProjectionMatrix(), m_viewportMatrix,
+            glm::vec4(m_cameraPosition, 1.0f)};
+  }
+
   void Camera::setViewportU(glm::vec2 u) {
     m_viewportU = u;
 
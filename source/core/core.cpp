@@ -1,22 +1,71 @@
 #include <bloomCG/core/core.hpp>
 
+// KHR_debug tokens, in case the loader was generated without the extension
+#ifndef GL_DEBUG_OUTPUT
+#  define GL_DEBUG_OUTPUT 0x92E0
+#endif
+#ifndef GL_DEBUG_OUTPUT_SYNCHRONOUS
+#  define GL_DEBUG_OUTPUT_SYNCHRONOUS 0x8242
+#endif
+#ifndef GL_DEBUG_TYPE_ERROR
+#  define GL_DEBUG_TYPE_ERROR 0x824C
+#endif
+#ifndef GL_DEBUG_SEVERITY_NOTIFICATION
+#  define GL_DEBUG_SEVERITY_NOTIFICATION 0x826B
+#endif
+
 namespace bloom {
   GLFWwindow* gl::window;
+  gl::CallSite gl::s_callSite = {"", "", 0};
 
   void gl::clearError() {
     while (glGetError() != GL_NO_ERROR)
       ;
   }
 
-  bool gl::logCall() {
+  bool gl::logCall(const char* call, const char* file, int line) {
     while (GLenum error = glGetError()) {
-      fmt::print("OpenGL error: 0x{:04x}\n", error);
+      fmt::print("OpenGL error: 0x{:04x} in {} @ {}:{}\n", error, call, file, line);
       return false;
     }
 
     return true;
   }
 
+  typedef void(APIENTRY* DebugProc)(GLenum source, GLenum type, GLuint id, GLenum severity,
+                                    GLsizei length, const GLchar* message, const void* userParam);
+  typedef void(APIENTRY* DebugMessageCallbackProc)(DebugProc callback, const void* userParam);
+
+  static void APIENTRY debugMessageCallback(GLenum source, GLenum type, GLuint id, GLenum severity,
+                                            GLsizei length, const GLchar* message,
+                                            const void* userParam) {
+    if (severity == GL_DEBUG_SEVERITY_NOTIFICATION) return;
+
+    const gl::CallSite& site = gl::getCallSite();
+    fmt::print("OpenGL {} 0x{:x}: {}\n  last call: {} @ {}:{}\n",
+               type == GL_DEBUG_TYPE_ERROR ? "error" : "message", id,
+               std::string_view(message, length), site.call, site.file, site.line);
+  }
+
+  bool gl::enableDebugOutput() {
+    // Resolved by hand so it doesn't depend on which extensions the loader was generated with
+    auto installCallback = (DebugMessageCallbackProc)glfwGetProcAddress("glDebugMessageCallback");
+    if (!installCallback)
+      installCallback = (DebugMessageCallbackProc)glfwGetProcAddress("glDebugMessageCallbackARB");
+
+    if (!installCallback) {
+      fmt::print("KHR_debug is not available, GL errors won't be reported\n");
+      return false;
+    }
+
+    glEnable(GL_DEBUG_OUTPUT);
+    // Report from within the failing call, otherwise the recorded call site could be stale
+    glEnable(GL_DEBUG_OUTPUT_SYNCHRONOUS);
+    installCallback(debugMessageCallback, nullptr);
+
+    return true;
+  }
+
   void gl::setWindow(GLFWwindow* window) { gl::window = window; }
   GLFWwindow* gl::getWindow() { return gl::window; }
 }  // namespace bloom
@@ -0,0 +1,166 @@
+#include <bloomCG/core/job_system.hpp>
+
+namespace bloom {
+  thread_local uint32_t JobSystem::t_queue = 0;
+
+  JobSystem::JobSystem(uint32_t workerCount) {
+    if (workerCount == 0)
+      workerCount = std::max(1u, std::thread::hardware_concurrency()) - 1;
+    workerCount = std::max(1u, workerCount);
+
+    // Every queue exists before a worker may steal from it
+    for (uint32_t i = 0; i <= workerCount; i++) m_queues.push_back(std::make_unique<Queue>());
+    for (uint32_t i = 1; i <= workerCount; i++) m_workers.emplace_back([this, i]() { work(i); });
+  }
+
+  JobSystem::~JobSystem() {
+    m_stopping = true;
+    {
+      std::lock_guard<std::mutex> lock(m_sleepMutex);
+    }
+    m_wake.notify_all();
+
+    for (std::thread& worker : m_workers) worker.join();
+  }
+
+  void JobSystem::wake() {
+    // Taking the lock orders this with a worker checking for jobs and going to sleep
+    {
+      std::lock_guard<std::mutex> lock(m_sleepMutex);
+    }
+    m_wake.notify_one();
+  }
+
+  void JobSystem::push(Job job) {
+    Queue& queue = *m_queues[t_queue];
+    {
+      std::lock_guard<std::mutex> lock(queue.mutex);
+      queue.jobs.push_back(std::move(job));
+    }
+    m_queued++;
+    wake();
+  }
+
+  bool JobSystem::pop(Job& job) {
+    Queue& queue = *m_queues[t_queue];
+    std::lock_guard<std::mutex> lock(queue.mutex);
+    if (queue.jobs.empty()) return false;
+
+    // Newest first, its data is the most likely to still be in cache
+    job = std::move(queue.jobs.back());
+    queue.jobs.pop_back();
+    m_queued--;
+    return true;
+  }
+
+  bool JobSystem::steal(Job& job) {
+    for (std::size_t i = 1; i < m_queues.size(); i++) {
+      Queue& queue = *m_queues[(t_queue + i) % m_queues.size()];
+      std::lock_guard<std::mutex> lock(queue.mutex);
+      if (queue.jobs.empty()) continue;
+
+      // Oldest first, away from the owner working at the back
+      job = std::move(queue.jobs.front());
+      queue.jobs.pop_front();
+      m_queued--;
+      return true;
+    }
+
+    return false;
+  }
+
+  void JobSystem::finish(JobCounter* counter) {
+    if (!counter) return;
+
+    std::vector<Job> continuations;
+    {
+      // Held while decrementing, wait() takes it before letting the counter be destroyed
+      std::lock_guard<std::mutex> lock(counter->m_mutex);
+      if (counter->m_count.fetch_sub(1, std::memory_order_acq_rel) == 1)
+        continuations.swap(counter->m_continuations);
+    }
+
+    for (Job& continuation : continuations) push(std::move(continuation));
+  }
+
+  void JobSystem::run(Job job, JobCounter* counter, JobCounter* dependency) {
+    if (counter) counter->m_count.fetch_add(1, std::memory_order_relaxed);
+
+    Job counted = [this, job = std::move(job), counter]() {
+      job();
+      finish(counter);
+    };
+
+    if (dependency) {
+      std::lock_guard<std::mutex> lock(dependency->m_mutex);
+      if (!dependency->isDone()) {
+        dependency->m_continuations.push_back(std::move(counted));
+        return;
+      }
+    }
+
+    push(std::move(counted));
+  }
+
+  void JobSystem::wait(JobCounter& counter) {
+    while (!counter.isDone()) {
+      Job job;
+      if (pop(job) || steal(job))
+        job();
+      else
+        std::this_thread::yield();
+    }
+
+    // The last job may still be releasing the counter
+    std::lock_guard<std::mutex> lock(counter.m_mutex);
+  }
+
+  void JobSystem::runOnMainThread(Job job) {
+    std::lock_guard<std::mutex> lock(m_mainMutex);
+    m_mainJobs.push_back(std::move(job));
+  }
+
+  void JobSystem::executeMainThreadJobs() {
+    std::vector<Job> jobs;
+    {
+      std::lock_guard<std::mutex> lock(m_mainMutex);
+      jobs.swap(m_mainJobs);
+    }
+
+    // Jobs queued by these ones run next frame
+    for (Job& job : jobs) job();
+  }
+
+  void JobSystem::work(uint32_t queue) {
+    t_queue = queue;
+
+    while (!m_stopping) {
+      Job job;
+      if (pop(job) || steal(job)) {
+        job();
+        continue;
+      }
+
+      {
+        std::lock_guard<std::mutex> lock(m_background.mutex);
+        if (!m_background.jobs.empty()) {
+          job = std::move(m_background.jobs.front());
+          m_background.jobs.pop_front();
+          m_queued--;
+        }
+      }
+      if (job) {
+        job();
+        continue;
+      }
+
+      std::unique_lock<std::mutex> lock(m_sleepMutex);
+      m_wake.wait(lock, [this]() { return m_stopping || m_queued > 0; });
+    }
+  }
+
+  JobSystem& JobSystem::get() {
+    static JobSystem system;
+    return system;
+  }
+}  // namespace bloom
@@ -0,0 +1,174 @@
+#include <bloomCG/core/core.hpp>
+#include <bloomCG/core/light_clusters.hpp>
+
+#include <algorithm>
+#include <limits>
+
+namespace bloom {
+  LightClusters::LightClusters()
+      : m_bounds(CLUSTER_COUNT), m_clusters(CLUSTER_COUNT, glm::uvec2{0}) {
+    m_clusterBuffer = std::make_unique<bloom::TextureBuffer>(CLUSTER_COUNT * sizeof(glm::uvec2),
+                                                             GL_RG32UI);
+    m_lightIndexBuffer = std::make_unique<bloom::TextureBuffer>(1024 * sizeof(uint32_t), GL_R32UI);
+  }
+
+  float LightClusters::getLightRange(const bloom::PointLightData& light) {
+    const float intensity = std::max({light.intensity.x, light.intensity.y, light.intensity.z});
+    if (intensity <= 0.f) return 0.f;
+
+    // Distance at which constant + linear * d + quadratic * d^2 = intensity / cutoff
+    const float target = intensity / LIGHT_CUTOFF;
+    if (light.quadratic > 0.f) {
+      const float discriminant
+          = light.linear * light.linear - 4.f * light.quadratic * (light.constant - target);
+      return std::max(0.f, (-light.linear + std::sqrt(discriminant)) / (2.f * light.quadratic));
+    }
+    if (light.linear > 0.f) return std::max(0.f, (target - light.constant) / light.linear);
+
+    return std::numeric_limits<float>::infinity();
+  }
+
+  void LightClusters::rebuildBounds(const glm::mat4& projection, float near, float far) {
+    m_projection = projection;
+    m_near = near;
+    m_far = far;
+
+    const glm::mat4 inverseProjection = glm::inverse(projection);
+    auto unproject = [&inverseProjection](float x, float y, float z) {
+      glm::vec4 point = inverseProjection * glm::vec4(x, y, z, 1.f);
+      return glm::vec3(point) / point.w;
+    };
+
+    // Point of the NDC column (x, y) lying at view space depth `depth`
+    auto atDepth = [&unproject](float x, float y, float depth) {
+      glm::vec3 nearPoint = unproject(x, y, -1.f);
+      glm::vec3 farPoint = unproject(x, y, 1.f);
+      float t = (-depth - nearPoint.z) / (farPoint.z - nearPoint.z);
+      return nearPoint + t * (farPoint - nearPoint);
+    };
+
+    for (uint32_t z = 0; z < GRID_Z; z++) {
+      const float depthNear = near * std::pow(far / near, (float)z / GRID_Z);
+      const float depthFar = near * std::pow(far / near, (float)(z + 1) / GRID_Z);
+
+      for (uint32_t y = 0; y < GRID_Y; y++) {
+        const float y0 = -1.f + 2.f * y / GRID_Y, y1 = -1.f + 2.f * (y + 1) / GRID_Y;
+
+        for (uint32_t x = 0; x < GRID_X; x++) {
+          const float x0 = -1.f + 2.f * x / GRID_X, x1 = -1.f + 2.f * (x + 1) / GRID_X;
+
+          Bounds& bounds = m_bounds[x + GRID_X * (y + GRID_Y * z)];
+          bounds.min = glm::vec3(std::numeric_limits<float>::max());
+          bounds.max = glm::vec3(std::numeric_limits<float>::lowest());
+
+          for (float depth : {depthNear, depthFar}) {
+            for (glm::vec2 corner : {glm::vec2{x0, y0}, glm::vec2{x1, y0}, glm::vec2{x0, y1},
+                                     glm::vec2{x1, y1}}) {
+              glm::vec3 point = atDepth(corner.x, corner.y, depth);
+              bounds.min = glm::min(bounds.min, point);
+              bounds.max = glm::max(bounds.max, point);
+            }
+          }
+        }
+      }
+    }
+  }
+
+  void LightClusters::update(const bloom::Camera& camera,
+                             const std::vector<bloom::PointLightData>& lights) {
+    const glm::mat4 projection = camera.getProjectionMatrix();
+    if (projection != m_projection || camera.getNearPlane() != m_near
+        || camera.getFarPlane() != m_far)
+      rebuildBounds(projection, camera.getNearPlane(), camera.getFarPlane());
+
+    const glm::mat4 view = camera.getViewMatrix();
+    const float depthScale = getDepthScale();
+    auto slice = [this, depthScale](float depth) {
+      int z = (int)std::floor(std::log(depth / m_near) * depthScale);
+      return (uint32_t)std::clamp(z, 0, (int)GRID_Z - 1);
+    };
+    auto tile = [](float ndc, uint32_t count) {
+      int index = (int)std::floor((ndc * .5f + .5f) * count);
+      return (uint32_t)std::clamp(index, 0, (int)count - 1);
+    };
+
+    m_pairs.clear();
+    std::fill(m_clusters.begin(), m_clusters.end(), glm::uvec2{0});
+
+    for (uint32_t i = 0; i < lights.size(); i++) {
+      const float range = getLightRange(lights[i]);
+      if (range <= 0.f) continue;
+
+      const glm::vec3 center = glm::vec3(view * glm::vec4(lights[i].position, 1.f));
+      const float depth = -center.z;
+      if (depth + range < m_near || depth - range > m_far) continue;
+
+      const uint32_t zMin = slice(std::max(depth - range, m_near));
+      const uint32_t zMax = slice(std::min(depth + range, m_far));
+
+      // Screen tiles covered by the projection of the light's bounding box. A box crossing the
+      // camera plane can't be projected, so it covers the whole screen.
+      uint32_t xMin = 0, xMax = GRID_X - 1, yMin = 0, yMax = GRID_Y - 1;
+      if (std::isfinite(range) && depth - range > 0.f) {
+        glm::vec2 ndcMin(std::numeric_limits<float>::max());
+        glm::vec2 ndcMax(std::numeric_limits<float>::lowest());
+        for (int corner = 0; corner < 8; corner++) {
+          glm::vec3 offset{corner & 1 ? range : -range, corner & 2 ? range : -range,
+                           corner & 4 ? range : -range};
+          glm::vec4 clip = projection * glm::vec4(center + offset, 1.f);
+          glm::vec2 ndc = glm::vec2(clip) / clip.w;
+          ndcMin = glm::min(ndcMin, ndc);
+          ndcMax = glm::max(ndcMax, ndc);
+        }
+
+        if (ndcMax.x < -1.f || ndcMin.x > 1.f || ndcMax.y < -1.f || ndcMin.y > 1.f) continue;
+
+        xMin = tile(ndcMin.x, GRID_X), xMax = tile(ndcMax.x, GRID_X);
+        yMin = tile(ndcMin.y, GRID_Y), yMax = tile(ndcMax.y, GRID_Y);
+      }
+
+      const float rangeSquared = range * range;
+      for (uint32_t z = zMin; z <= zMax; z++) {
+        for (uint32_t y = yMin; y <= yMax; y++) {
+          for (uint32_t x = xMin; x <= xMax; x++) {
+            const uint32_t cluster = x + GRID_X * (y + GRID_Y * z);
+            const Bounds& bounds = m_bounds[cluster];
+
+            // Sphere vs. box: distance from the center to the closest point of the box
+            const glm::vec3 closest = glm::clamp(center, bounds.min, bounds.max);
+            const glm::vec3 delta = closest - center;
+            if (glm::dot(delta, delta) > rangeSquared) continue;
+
+            m_pairs.push_back({cluster, i});
+            m_clusters[cluster].y++;
+          }
+        }
+      }
+    }
+
+    // Counting sort of the pairs by cluster. Pairs were emitted light by light, so each cluster
+    // keeps its lights in upload order.
+    uint32_t offset = 0;
+    for (auto& cluster : m_clusters) {
+      cluster.x = offset;
+      offset += cluster.y;
+    }
+
+    m_lightIndices.resize(m_pairs.size());
+    for (auto& cluster : m_clusters) cluster.y = 0;
+    for (const auto& pair : m_pairs) {
+      glm::uvec2& cluster = m_clusters[pair.x];
+      m_lightIndices[cluster.x + cluster.y++] = pair.y;
+    }
+
+    m_clusterBuffer->setData(m_clusters.data(), CLUSTER_COUNT * sizeof(glm::uvec2));
+    if (!m_lightIndices.empty())
+      m_lightIndexBuffer->setData(m_lightIndices.data(),
+                                  m_lightIndices.size() * sizeof(uint32_t));
+  }
+
+  void LightClusters::bind(uint32_t clustersSlot, uint32_t lightIndicesSlot) const {
+    m_clusterBuffer->bind(clustersSlot);
+    m_lightIndexBuffer->bind(lightIndicesSlot);
+  }
+}  // namespace bloom
@@ -0,0 +1,235 @@
+#include <bloomCG/core/profiler.hpp>
+
+#ifdef BLOOM_PROFILE
+
+#include <bloomCG/core/core.hpp>
+
+#include <algorithm>
+#include <cfloat>
+#include <chrono>
+#include <map>
+
+namespace bloom {
+  std::array<Profiler::Frame, Profiler::HISTORY_SIZE> Profiler::s_history;
+  std::size_t Profiler::s_frameIndex = 0;
+  double Profiler::s_frameStart = 0.0;
+  uint32_t Profiler::s_depth = 0;
+
+  std::array<std::vector<Profiler::GpuQuery>, Profiler::QUERY_BUFFERS> Profiler::s_gpuQueries;
+  std::vector<uint32_t> Profiler::s_freeQueries;
+  bool Profiler::s_gpuScopeActive = false;
+
+  double Profiler::now() {
+    using namespace std::chrono;
+    return duration<double, std::milli>(steady_clock::now().time_since_epoch()).count();
+  }
+
+  Profiler::Frame& Profiler::current() { return s_history[(s_frameIndex - 1) % HISTORY_SIZE]; }
+
+  void Profiler::beginFrame() {
+    if (s_frameIndex > 0) current().duration = now() - s_frameStart;
+
+    s_frameIndex++;
+
+    // This buffer holds the queries of two frames ago, collect them before reusing it
+    const std::size_t buffer = (s_frameIndex - 1) % QUERY_BUFFERS;
+    if (s_frameIndex > QUERY_BUFFERS)
+      resolveGpuQueries(buffer, s_history[(s_frameIndex - 1 - QUERY_BUFFERS) % HISTORY_SIZE]);
+
+    Frame& frame = current();
+    frame.duration = 0.0;
+    frame.gpuDuration = 0.0;
+    frame.cpuScopes.clear();
+    frame.gpuScopes.clear();
+    frame.gpuResolved = false;
+
+    s_depth = 0;
+    s_frameStart = now();
+  }
+
+  std::size_t Profiler::beginScope(const char* name) {
+    if (s_frameIndex == 0) return SIZE_MAX;
+
+    auto& scopes = current().cpuScopes;
+    scopes.push_back({name, s_depth++, now() - s_frameStart, 0.0});
+    return scopes.size() - 1;
+  }
+
+  void Profiler::endScope(std::size_t index) {
+    if (index == SIZE_MAX) return;
+
+    current().cpuScopes[index].end = now() - s_frameStart;
+    s_depth--;
+  }
+
+  bool Profiler::beginGpuScope(const char* name) {
+    if (s_frameIndex == 0 || s_gpuScopeActive) return false;
+
+    uint32_t query;
+    if (s_freeQueries.empty()) {
+      GLCall(glad_glGenQueries(1, &query));
+    } else {
+      query = s_freeQueries.back();
+      s_freeQueries.pop_back();
+    }
+
+    GLCall(glad_glBeginQuery(GL_TIME_ELAPSED, query));
+    s_gpuQueries[(s_frameIndex - 1) % QUERY_BUFFERS].push_back({name, query});
+    s_gpuScopeActive = true;
+
+    return true;
+  }
+
+  void Profiler::endGpuScope() {
+    GLCall(glad_glEndQuery(GL_TIME_ELAPSED));
+    s_gpuScopeActive = false;
+  }
+
+  void Profiler::resolveGpuQueries(std::size_t buffer, Frame& frame) {
+    bool complete = true;
+    double cursor = 0.0;
+
+    for (const auto& gpuQuery : s_gpuQueries[buffer]) {
+      int32_t available = 0;
+      GLCall(glad_glGetQueryObjectiv(gpuQuery.query, GL_QUERY_RESULT_AVAILABLE, &available));
+
+      if (available) {
+        uint64_t elapsed = 0;  // Nanoseconds
+        GLCall(glad_glGetQueryObjectui64v(gpuQuery.query, GL_QUERY_RESULT, &elapsed));
+
+        const double duration = elapsed / 1e6;
+        frame.gpuScopes.push_back({gpuQuery.name, 0, cursor, cursor + duration});
+        cursor += duration;
+      } else {
+        complete = false;
+      }
+
+      s_freeQueries.push_back(gpuQuery.query);
+    }
+
+    s_gpuQueries[buffer].clear();
+    frame.gpuDuration = cursor;
+    frame.gpuResolved = complete;
+  }
+
+  const Profiler::Frame* Profiler::getLastResolvedFrame() {
+    if (s_frameIndex <= QUERY_BUFFERS) return nullptr;
+    return &s_history[(s_frameIndex - 1 - QUERY_BUFFERS) % HISTORY_SIZE];
+  }
+
+  static ImU32 scopeColor(const char* name) {
+    const std::size_t hash = std::hash<std::string_view>()(name);
+    return IM_COL32(70 + hash % 140, 70 + (hash >> 8) % 140, 70 + (hash >> 16) % 140, 255);
+  }
+
+  void Profiler::onImGuiRender() {
+    ImGui::Begin("Profiler");
+
+    const Frame* frame = getLastResolvedFrame();
+    if (!frame) {
+      ImGui::Text("Collecting frames...");
+      ImGui::End();
+      return;
+    }
+
+    // Frames whose data is complete, oldest first
+    const std::size_t last = s_frameIndex - 1 - QUERY_BUFFERS;
+    const std::size_t count = std::min(last + 1, HISTORY_SIZE - QUERY_BUFFERS);
+    const std::size_t first = last + 1 - count;
+
+    // ==== Frame times ====
+    std::array<float, HISTORY_SIZE> frameTimes;
+    for (std::size_t i = 0; i < count; i++)
+      frameTimes[i] = (float)s_history[(first + i) % HISTORY_SIZE].duration;
+
+    ImGui::Text("CPU %.2f ms | GPU %.2f ms%s", frame->duration, frame->gpuDuration,
+                frame->gpuResolved ? "" : " (some GPU results were not ready)");
+    ImGui::PlotLines("##frameTimes", frameTimes.data(), (int)count, 0, "Frame time (ms)", 0.0f,
+                     FLT_MAX, ImVec2(ImGui::GetContentRegionAvail().x, 60));
+
+    // ==== Flame bars ====
+    // CPU scopes stacked by depth, GPU scopes in their own row below
+    const float width = ImGui::GetContentRegionAvail().x;
+    const float rowHeight = ImGui::GetFontSize() + 4.0f;
+    const double scale = width / std::max({frame->duration, frame->gpuDuration, 1e-3});
+
+    uint32_t cpuRows = 0;
+    for (const auto& scope : frame->cpuScopes) cpuRows = std::max(cpuRows, scope.depth + 1);
+
+    const ImVec2 origin = ImGui::GetCursorScreenPos();
+    ImDrawList* drawList = ImGui::GetWindowDrawList();
+
+    auto drawScope = [&](const Scope& scope, float y) {
+      const ImVec2 min(origin.x + (float)(scope.start * scale), y);
+      const ImVec2 max(origin.x + (float)(scope.end * scale), y + rowHeight - 1.0f);
+      if (max.x - min.x < 1.0f) return;
+
+      drawList->AddRectFilled(min, max, scopeColor(scope.name));
+      if (ImGui::CalcTextSize(scope.name).x < max.x - min.x - 4.0f)
+        drawList->AddText(ImVec2(min.x + 2.0f, min.y + 2.0f), IM_COL32(0, 0, 0, 255), scope.name);
+
+      if (ImGui::IsMouseHoveringRect(min, max))
+        ImGui::SetTooltip("%s: %.3f ms", scope.name, scope.end - scope.start);
+    };
+
+    for (const auto& scope : frame->cpuScopes) drawScope(scope, origin.y + scope.depth * rowHeight);
+    for (const auto& scope : frame->gpuScopes)
+      drawScope(scope, origin.y + (cpuRows + 0.5f) * rowHeight);
+
+    ImGui::Dummy(ImVec2(width, (cpuRows + 1.5f) * rowHeight));
+
+    // ==== Percentiles ====
+    // Time per scope name and frame, a scope entered several times in a frame is summed up
+    std::map<std::pair<bool, std::string_view>, std::vector<double>> samples;
+    for (std::size_t i = 0; i < count; i++) {
+      const Frame& history = s_history[(first + i) % HISTORY_SIZE];
+
+      std::map<std::pair<bool, std::string_view>, double> totals;
+      for (const auto& scope : history.cpuScopes)
+        totals[{false, scope.name}] += scope.end - scope.start;
+      for (const auto& scope : history.gpuScopes)
+        totals[{true, scope.name}] += scope.end - scope.start;
+
+      for (const auto& [key, total] : totals) samples[key].push_back(total);
+    }
+
+    if (ImGui::BeginTable("##profilerScopes", 6, ImGuiTableFlags_Borders | ImGuiTableFlags_RowBg)) {
+      for (const char* column : {"Scope", "", "avg", "p50", "p95", "p99"})
+        ImGui::TableSetupColumn(column);
+      ImGui::TableHeadersRow();
+
+      for (auto& sample : samples) {
+        const auto& key = sample.first;
+        std::vector<double>& durations = sample.second;
+        std::sort(durations.begin(), durations.end());
+
+        auto percentile = [&durations](double p) {
+          return durations[std::min(durations.size() - 1, (std::size_t)(p * durations.size()))];
+        };
+
+        double sum = 0.0;
+        for (double duration : durations) sum += duration;
+
+        ImGui::TableNextRow();
+        ImGui::TableNextColumn();
+        ImGui::TextUnformatted(key.second.data(), key.second.data() + key.second.size());
+        ImGui::TableNextColumn();
+        ImGui::TextUnformatted(key.first ? "GPU" : "CPU");
+        ImGui::TableNextColumn();
+        ImGui::Text("%.3f", sum / durations.size());
+        ImGui::TableNextColumn();
+        ImGui::Text("%.3f", percentile(.50));
+        ImGui::TableNextColumn();
+        ImGui::Text("%.3f", percentile(.95));
+        ImGui::TableNextColumn();
+        ImGui::Text("%.3f", percentile(.99));
+      }
+
+      ImGui::EndTable();
+    }
+
+    ImGui::End();
+  }
+}  // namespace bloom
+
+#endif
@@ -0,0 +1,130 @@
+#include <bloomCG/core/core.hpp>
+#include <bloomCG/core/render_queue.hpp>
+
+namespace bloom {
+  uint64_t RenderQueue::makeKey(const DrawItem& item) {
+    // Positive floats compare like their bit patterns, so the depth can be sorted as an integer
+    const float clampedDepth = std::max(item.depth, 0.0f);
+    uint32_t depth;
+    std::memcpy(&depth, &clampedDepth, sizeof(float));
+
+    const uint64_t program = item.shader->getRendererID() & 0x7fff;
+    const uint64_t mesh = (item.mesh->getVertexArray()->getRendererID() & 0xfff) << 4
+                          | std::min(item.lod, 0xfu);
+
+    if (item.translucent)
+      return (1ull << 63) | ((uint64_t)~depth << 31) | (program << 16) | mesh;
+
+    return (program << 48) | (mesh << 32) | depth;
+  }
+
+  void RenderQueue::submit(const DrawItem& item) {
+    m_entries.push_back({makeKey(item), (uint32_t)m_items.size()});
+    m_items.push_back(item);
+    m_sorted = false;
+  }
+
+  void RenderQueue::clear() {
+    m_items.clear();
+    m_entries.clear();
+    m_sorted = true;
+  }
+
+  void RenderQueue::sort() {
+    if (m_sorted) return;
+
+    radixSort();
+    m_sorted = true;
+  }
+
+  void RenderQueue::radixSort() {
+    constexpr int passes = sizeof(uint64_t);
+    const std::size_t count = m_entries.size();
+    if (count < 2) return;
+
+    // One histogram per byte, filled in a single sweep
+    std::array<std::array<uint32_t, 256>, passes> histograms{};
+    for (const auto& entry : m_entries) {
+      for (int pass = 0; pass < passes; pass++)
+        histograms[pass][(entry.key >> (pass * 8)) & 0xff]++;
+    }
+
+    m_scratch.resize(count);
+    for (int pass = 0; pass < passes; pass++) {
+      auto& histogram = histograms[pass];
+
+      // Every key shares this byte (e.g. no translucent items, or few programs): nothing to do
+      const uint8_t first = (m_entries.front().key >> (pass * 8)) & 0xff;
+      if (histogram[first] == count) continue;
+
+      uint32_t offset = 0;
+      for (auto& bucket : histogram) {
+        const uint32_t size = bucket;
+        bucket = offset;
+        offset += size;
+      }
+
+      // Stable scatter, keeps the order established by the previous (less significant) bytes
+      for (const auto& entry : m_entries)
+        m_scratch[histogram[(entry.key >> (pass * 8)) & 0xff]++] = entry;
+
+      m_entries.swap(m_scratch);
+    }
+  }
+
+  const DrawItem& RenderQueue::operator[](std::size_t index) {
+    sort();
+    return m_items[m_entries[index].index];
+  }
+
+  void RenderQueue::execute(const std::function<void(bloom::Shader*)>& onProgramBind) {
+    sort();
+
+    m_programChanges = 0;
+    m_meshChanges = 0;
+
+    bloom::Shader* boundShader = nullptr;
+    bloom::Mesh* boundMesh = nullptr;
+
+    // Per draw uniforms, resolved once per program switch
+    bloom::Uniform<glm::mat4> model;
+    bloom::Uniform<glm::mat3> normal;
+    bloom::Uniform<glm::vec3> ambient, diffuse, specular;
+    bloom::Uniform<float> shininess;
+
+    for (const auto& entry : m_entries) {
+      const DrawItem& item = m_items[entry.index];
+
+      if (item.shader != boundShader) {
+        boundShader = item.shader->bind();
+        if (onProgramBind) onProgramBind(boundShader);
+
+        model = boundShader->getUniform<glm::mat4>("uModel");
+        normal = boundShader->getUniform<glm::mat3>("uNormalMatrix");
+        ambient = boundShader->getUniform<glm::vec3>("uMaterial.ambient");
+        diffuse = boundShader->getUniform<glm::vec3>("uMaterial.diffuse");
+        specular = boundShader->getUniform<glm::vec3>("uMaterial.specular");
+        shininess = boundShader->getUniform<float>("uMaterial.shininess");
+        m_programChanges++;
+      }
+
+      if (item.mesh != boundMesh) {
+        boundMesh = item.mesh;
+        boundMesh->bind();
+        m_meshChanges++;
+      }
+
+      boundShader->set(model, item.instance.model)
+          ->set(normal, glm::mat3(item.instance.normal))
+          ->set(ambient, glm::vec3(item.instance.ambient))
+          ->set(diffuse, glm::vec3(item.instance.diffuse))
+          ->set(specular, glm::vec3(item.instance.specular))
+          ->set(shininess, item.instance.specular.w);
+
+      boundMesh->submit(1, item.lod);
+    }
+
+    if (boundMesh) boundMesh->unbind();
+    if (boundShader) boundShader->unbind();
+  }
+}  // namespace bloom
@@ -2,6 +2,7 @@
 #include <bloomCG/core/renderer.hpp>
 
 namespace bloom {
+  RenderStats Renderer::s_stats;
   ImDrawList* Renderer::s_viewportDrawList = nullptr;
   float Renderer::s_viewportWidth = 0.0f;
   float Renderer::s_viewportHeight = 0.0f;
@@ -4,9 +4,11 @@
 
 namespace bloom {
 
-  Shader::Shader(const std::string& filename) : m_filepath(filename), m_rendererID(0) {
+  Shader::Shader(const std::string& filename, const std::vector<std::string>& defines)
+      : m_filepath(filename), m_defines(defines), m_rendererID(0) {
     ShaderProgramSource source = parseShader(filename);
     m_rendererID = createShader(source.vertexSource, source.fragmentSource);
+    reflectUniforms();
   }
 
   Shader::~Shader() { GLCall(glad_glDeleteProgram((m_rendererID))); }
@@ -18,44 +20,108 @@ namespace bloom {
 
   void Shader::unbind() const { GLCall(glad_glUseProgram(0)); }
 
-  Shader* Shader::setUniformMat4f(const std::string& name, const glm::mat4& matrix) {
-    GLCall(glad_glUniformMatrix4fv(getUniformLocation(name), 1, GL_FALSE, glm::value_ptr(matrix)));
+  Shader* Shader::set(Uniform<glm::mat4> uniform, const glm::mat4& matrix) {
+    GLCall(glad_glUniformMatrix4fv(uniform.location, 1, GL_FALSE, glm::value_ptr(matrix)));
     return this;
   }
 
-  Shader* Shader::setUniform1i(const std::string& name, int value) {
-    GLCall(glad_glUniform1i(getUniformLocation(name), value));
+  Shader* Shader::set(Uniform<glm::mat3> uniform, const glm::mat3& matrix) {
+    GLCall(glad_glUniformMatrix3fv(uniform.location, 1, GL_FALSE, glm::value_ptr(matrix)));
     return this;
   }
 
-  Shader* Shader::setUniform1f(const std::string& name, const float& value) {
-    GLCall(glad_glUniform1f(getUniformLocation(name), value));
+  Shader* Shader::set(Uniform<float> uniform, float value) {
+    GLCall(glad_glUniform1f(uniform.location, value));
     return this;
   }
 
-  Shader* Shader::setUniform3f(const std::string& name, const glm::vec3& value) {
-    GLCall(glad_glUniform3f(getUniformLocation(name), value.x, value.y, value.z));
+  Shader* Shader::set(Uniform<glm::vec2> uniform, const glm::vec2& value) {
+    GLCall(glad_glUniform2f(uniform.location, value.x, value.y));
     return this;
   }
 
-  Shader* Shader::setUniform4f(const std::string& name, const glm::vec4& value) {
-    GLCall(glad_glUniform4f(getUniformLocation(name), value.x, value.y, value.z, value.w));
+  Shader* Shader::set(Uniform<glm::vec3> uniform, const glm::vec3& value) {
+    GLCall(glad_glUniform3f(uniform.location, value.x, value.y, value.z));
     return this;
   }
 
-  int32_t Shader::getUniformLocation(const std::string& name) {
-    if (m_uniformLocationCache.find(name) != m_uniformLocationCache.end())
-      return m_uniformLocationCache[name];
+  Shader* Shader::set(Uniform<glm::vec4> uniform, const glm::vec4& value) {
+    GLCall(glad_glUniform4f(uniform.location, value.x, value.y, value.z, value.w));
+    return this;
+  }
+
+  Shader* Shader::set(Uniform<int32_t> uniform, int32_t value) {
+    GLCall(glad_glUniform1i(uniform.location, value));
+    return this;
+  }
+
+  Shader* Shader::setUniformMat4f(UniformName name, const glm::mat4& matrix) {
+    return set(getUniform<glm::mat4>(name), matrix);
+  }
+
+  Shader* Shader::setUniform1i(UniformName name, int value) {
+    return set(getUniform<int32_t>(name), value);
+  }
+
+  Shader* Shader::setUniform1f(UniformName name, const float& value) {
+    return set(getUniform<float>(name), value);
+  }
+
+  Shader* Shader::setUniform2f(UniformName name, const glm::vec2& value) {
+    return set(getUniform<glm::vec2>(name), value);
+  }
+
+  Shader* Shader::setUniform3f(UniformName name, const glm::vec3& value) {
+    return set(getUniform<glm::vec3>(name), value);
+  }
 
-    GLCall(int32_t location = glad_glGetUniformLocation(m_rendererID, name.c_str()));
+  Shader* Shader::setUniform4f(UniformName name, const glm::vec4& value) {
+    return set(getUniform<glm::vec4>(name), value);
+  }
+
+  Shader* Shader::setUniformBlockBinding(const std::string& name, uint32_t binding) {
+    GLCall(uint32_t index = glad_glGetUniformBlockIndex(m_rendererID, name.c_str()));
+    if (index != GL_INVALID_INDEX) {
+      GLCall(glad_glUniformBlockBinding(m_rendererID, index, binding));
+    }
+    return this;
+  }
 
-    if (location == -1) {
-      fmt::print("Warning: uniform '{}' doesn't exist!\n", name);
-      // ASSERT(false);
+  void Shader::reflectUniforms() {
+    int32_t count = 0, maxLength = 0;
+    GLCall(glad_glGetProgramiv(m_rendererID, GL_ACTIVE_UNIFORMS, &count));
+    GLCall(glad_glGetProgramiv(m_rendererID, GL_ACTIVE_UNIFORM_MAX_LENGTH, &maxLength));
+
+    std::string name(maxLength, '\0');
+    for (int32_t i = 0; i < count; i++) {
+      int32_t length = 0, size = 0;
+      uint32_t type = 0;
+      GLCall(glad_glGetActiveUniform(m_rendererID, i, maxLength, &length, &size, &type,
+                                     name.data()));
+
+      // Members of uniform blocks have no location, they are written through their buffer
+      const std::string_view uniformName(name.data(), length);
+      GLCall(int32_t location = glad_glGetUniformLocation(m_rendererID, name.c_str()));
+      if (location == -1) continue;
+
+      m_uniformLocations[hashUniformName(uniformName)] = location;
+
+      // Arrays are reported as "name[0]", make the bare name resolve too
+      if (uniformName.size() > 3 && uniformName.substr(uniformName.size() - 3) == "[0]")
+        m_uniformLocations[hashUniformName(uniformName.substr(0, uniformName.size() - 3))]
+            = location;
     }
+  }
 
-    m_uniformLocationCache[name] = location;
-    return location;
+  int32_t Shader::getUniformLocation(UniformName name) {
+    auto it = m_uniformLocations.find(name.hash);
+    if (it != m_uniformLocations.end()) return it->second;
+
+    fmt::print("Warning: uniform '{}' doesn't exist in '{}'!\n", name.name, m_filepath);
+
+    // Remember the miss, so the warning is printed once
+    m_uniformLocations[name.hash] = -1;
+    return -1;
   }
 
   [[nodiscard]] uint32_t Shader::compileShader(GLenum type, const std::string& source) {
@@ -138,6 +204,10 @@ namespace bloom {
         }
       } else {
         ss[(int)type] << line << '\n';
+
+        // `#version` must stay the first statement, so the variant defines go right after it
+        if (line.find("#version") != std::string::npos)
+          for (const auto& define : m_defines) ss[(int)type] << "#define " << define << '\n';
       }
     }
 
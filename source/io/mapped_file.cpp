@@ -0,0 +1,60 @@
+#include <bloomCG/io/mapped_file.hpp>
+
+#ifndef _WIN32
+#  include <fcntl.h>
+#  include <sys/mman.h>
+#  include <sys/stat.h>
+#  include <unistd.h>
+#endif
+
+namespace bloom {
+  namespace io {
+#ifdef _WIN32
+    MappedFile::MappedFile(const std::filesystem::path& path) {
+      std::ifstream file(path, std::ios::binary | std::ios::ate);
+      if (!file) return;
+
+      m_buffer.resize((std::size_t)file.tellg());
+      file.seekg(0);
+      if (!file.read(m_buffer.data(), m_buffer.size())) return;
+
+      m_data = m_buffer.data();
+      m_size = m_buffer.size();
+      m_open = true;
+    }
+
+    MappedFile::~MappedFile() {}
+#else
+    MappedFile::MappedFile(const std::filesystem::path& path) {
+      const int descriptor = ::open(path.c_str(), O_RDONLY);
+      if (descriptor < 0) return;
+
+      struct stat status;
+      if (::fstat(descriptor, &status) == 0) {
+        m_size = status.st_size;
+        m_open = true;
+
+        // Mapping nothing is an error, an empty file is just an empty view
+        if (m_size > 0) {
+          void* mapping = ::mmap(nullptr, m_size, PROT_READ, MAP_PRIVATE, descriptor, 0);
+          if (mapping == MAP_FAILED) {
+            m_size = 0;
+            m_open = false;
+          } else {
+            // Chunks are parsed in parallel, every page will be needed soon
+            ::madvise(mapping, m_size, MADV_WILLNEED);
+            m_data = (const char*)mapping;
+          }
+        }
+      }
+
+      // The mapping stays valid once the descriptor is closed
+      ::close(descriptor);
+    }
+
+    MappedFile::~MappedFile() {
+      if (m_data) ::munmap((void*)m_data, m_size);
+    }
+#endif
+  }  // namespace io
+}  // namespace bloom
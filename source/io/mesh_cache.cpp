@@ -0,0 +1,193 @@
+#include <bloomCG/io/mapped_file.hpp>
+#include <bloomCG/io/mesh_cache.hpp>
+#include <limits>
+
+namespace bloom {
+  namespace io {
+    std::filesystem::path MeshCache::s_directory = "cache/meshes";
+    bool MeshCache::s_enabled = true;
+
+    namespace {
+      constexpr uint64_t ALIGNMENT = 16;
+
+      inline uint64_t align(uint64_t offset) { return (offset + ALIGNMENT - 1) & ~(ALIGNMENT - 1); }
+
+      inline uint64_t mix(uint64_t value) {
+        value ^= value >> 30;
+        value *= 0xbf58476d1ce4e5b9ull;
+        value ^= value >> 27;
+        value *= 0x94d049bb133111ebull;
+        return value ^ (value >> 31);
+      }
+    }  // namespace
+
+    uint64_t hashBytes(const void* data, std::size_t size, uint64_t seed) {
+      constexpr uint64_t PRIME = 0x9e3779b97f4a7c15ull;
+      const unsigned char* bytes = (const unsigned char*)data;
+
+      // Four independent lanes of 8 bytes keep the multiplications pipelined on large blocks
+      uint64_t lanes[4] = {seed ^ PRIME, seed + PRIME, ~seed, seed ^ size};
+      std::size_t offset = 0;
+
+      for (; offset + 32 <= size; offset += 32) {
+        for (uint32_t lane = 0; lane < 4; lane++) {
+          uint64_t word;
+          std::memcpy(&word, bytes + offset + lane * 8, 8);
+          lanes[lane] = (lanes[lane] ^ mix(word)) * PRIME;
+        }
+      }
+
+      uint64_t hash
+          = mix(lanes[0]) ^ (mix(lanes[1]) * 3) ^ (mix(lanes[2]) * 5) ^ (mix(lanes[3]) * 7);
+
+      for (; offset + 8 <= size; offset += 8) {
+        uint64_t word;
+        std::memcpy(&word, bytes + offset, 8);
+        hash = (hash ^ mix(word)) * PRIME;
+      }
+
+      uint64_t tail = 0;
+      for (uint32_t i = 0; offset < size; offset++, i++)
+        tail |= (uint64_t)bytes[offset] << (i * 8);
+
+      return mix((hash ^ mix(tail)) * PRIME + size);
+    }
+
+    std::filesystem::path MeshCache::getPath(const std::string& name) {
+      return s_directory / (name + ".bmesh");
+    }
+
+    bool MeshCache::load(const std::string& name, uint64_t sourceHash, bloom::MeshData& data) {
+      if (!s_enabled) return false;
+
+      auto mapping = std::make_shared<MappedFile>(getPath(name));
+      const MappedFile& file = *mapping;
+      if (!file.isOpen() || file.size() < sizeof(MeshFileHeader)) return false;
+
+      MeshFileHeader header;
+      std::memcpy(&header, file.begin(), sizeof(header));
+
+      if (std::memcmp(header.magic, MESH_FILE_MAGIC, sizeof(header.magic)) != 0
+          || header.version != MESH_FILE_VERSION || header.sourceHash != sourceHash)
+        return false;
+
+      // Every section has to lie inside the file, aligned for the values it holds
+      auto fits = [&](uint64_t offset, uint64_t bytes) {
+        return offset % ALIGNMENT == 0 && offset <= file.size() && bytes <= file.size() - offset;
+      };
+
+      const uint64_t vertexBytes = (uint64_t)header.vertexCount * header.stride;
+      if (!fits(header.attributesOffset,
+                header.attributeCount * sizeof(bloom::VertexBufferLayoutElement))
+          || !fits(header.lodsOffset, header.lodCount * sizeof(MeshLod))
+          || !fits(header.verticesOffset, vertexBytes)
+          || !fits(header.indicesOffset, header.indexCount * sizeof(uint32_t))
+          || vertexBytes == 0 || vertexBytes > std::numeric_limits<uint32_t>::max())
+        return false;
+
+      bloom::VertexBufferLayout layout;
+      for (uint32_t attribute = 0; attribute < header.attributeCount; attribute++) {
+        bloom::VertexBufferLayoutElement element;
+        std::memcpy(&element,
+                    file.begin() + header.attributesOffset + attribute * sizeof(element),
+                    sizeof(element));
+        if (bloom::VertexBufferLayoutElement::getSizeOfType(element.type) == 0) return false;
+
+        layout.push(element);
+      }
+      if (layout.getStride() != header.stride) return false;
+
+      std::vector<MeshLod> lods(header.lodCount);
+      std::memcpy(lods.data(), file.begin() + header.lodsOffset, lods.size() * sizeof(MeshLod));
+      for (const MeshLod& lod : lods)
+        if ((uint64_t)lod.firstIndex + lod.indexCount > header.indexCount) return false;
+
+      // A damaged index would read outside the vertex buffer on the GPU
+      const uint32_t* indices = (const uint32_t*)(file.begin() + header.indicesOffset);
+      for (uint32_t i = 0; i < header.indexCount; i++)
+        if (indices[i] >= header.vertexCount) return false;
+
+      // Both blobs stay in the mapped pages, nothing is copied before the upload
+      data.vertices = file.begin() + header.verticesOffset;
+      data.vertexBytes = vertexBytes;
+      data.layout = layout;
+      data.indices = indices;
+      data.indexCount = header.indexCount;
+      data.lods = std::move(lods);
+      std::memcpy(&data.bounds.min, header.boundsMin, sizeof(header.boundsMin));
+      std::memcpy(&data.bounds.max, header.boundsMax, sizeof(header.boundsMax));
+      data.stats = {header.acmrBefore, header.acmrAfter};
+      data.storage = std::move(mapping);
+
+      return true;
+    }
+
+    void MeshCache::store(const std::string& name, uint64_t sourceHash,
+                          const bloom::MeshData& data) {
+      const uint64_t indexBytes = data.indexCount * sizeof(uint32_t);
+      if (!s_enabled || data.vertexBytes + indexBytes < MIN_CACHED_BYTES) return;
+
+      const std::vector<bloom::VertexBufferLayoutElement>& elements = data.layout.getElements();
+
+      MeshFileHeader header{};
+      std::memcpy(header.magic, MESH_FILE_MAGIC, sizeof(header.magic));
+      header.version = MESH_FILE_VERSION;
+      header.sourceHash = sourceHash;
+      header.attributeCount = elements.size();
+      header.stride = data.layout.getStride();
+      header.vertexCount = data.vertexBytes / header.stride;
+      header.indexCount = data.indexCount;
+      header.lodCount = data.lods.size();
+      std::memcpy(header.boundsMin, &data.bounds.min, sizeof(header.boundsMin));
+      std::memcpy(header.boundsMax, &data.bounds.max, sizeof(header.boundsMax));
+      header.acmrBefore = data.stats.acmrBefore;
+      header.acmrAfter = data.stats.acmrAfter;
+
+      header.attributesOffset = align(sizeof(header));
+      header.lodsOffset = align(header.attributesOffset
+                                + elements.size() * sizeof(bloom::VertexBufferLayoutElement));
+      header.verticesOffset = align(header.lodsOffset + data.lods.size() * sizeof(MeshLod));
+      header.indicesOffset = align(header.verticesOffset + data.vertexBytes);
+
+      std::error_code status;
+      const std::filesystem::path path = getPath(name);
+      std::filesystem::create_directories(path.parent_path(), status);
+
+      // Written next to the cache and renamed over it, a crash never leaves a truncated file.
+      // Every thread has its own temporary, the last rename wins.
+      std::filesystem::path temporary = path;
+      temporary += fmt::format(".{}.tmp", std::hash<std::thread::id>()(std::this_thread::get_id()));
+
+      {
+        std::ofstream file(temporary, std::ios::binary | std::ios::trunc);
+        auto section = [&](uint64_t offset, const void* bytes, uint64_t size) {
+          static constexpr char padding[ALIGNMENT] = {};
+          if (!file) return;
+
+          file.write(padding, offset - (uint64_t)file.tellp());
+          file.write((const char*)bytes, size);
+        };
+
+        section(0, &header, sizeof(header));
+        section(header.attributesOffset, elements.data(),
+                elements.size() * sizeof(bloom::VertexBufferLayoutElement));
+        section(header.lodsOffset, data.lods.data(), data.lods.size() * sizeof(MeshLod));
+        section(header.verticesOffset, data.vertices, data.vertexBytes);
+        section(header.indicesOffset, data.indices, indexBytes);
+
+        if (!file) {
+          fmt::print("Failed to write mesh cache: {}\n", temporary.string());
+          file.close();
+          std::filesystem::remove(temporary, status);
+          return;
+        }
+      }
+
+      std::filesystem::rename(temporary, path, status);
+      if (status) {
+        fmt::print("Failed to write mesh cache: {} ({})\n", path.string(), status.message());
+        std::filesystem::remove(temporary, status);
+      }
+    }
+  }  // namespace io
+}  // namespace bloom
@@ -0,0 +1,898 @@
+#include <algorithm>
+#include <bloomCG/core/job_system.hpp>
+#include <bloomCG/io/mapped_file.hpp>
+#include <bloomCG/io/mesh_importer.hpp>
+#include <charconv>
+#include <limits>
+#include <numeric>
+
+namespace bloom {
+  namespace io {
+    namespace {
+      // Below this much data per thread, splitting the work costs more than it saves
+      constexpr std::size_t MIN_CHUNK_SIZE = 1 << 20;
+
+      constexpr uint32_t NO_VERTEX = ~0u;
+
+      // Geometry as written in the file, before welding
+      struct RawMesh {
+        std::vector<glm::vec3> positions;
+        std::vector<glm::vec3> normals;
+        std::vector<uint32_t> positionIndices;  // Three per triangle
+
+        // One per corner when normals are indexed separately (OBJ), empty when they follow the
+        // positions (PLY) or aren't in the file
+        std::vector<uint32_t> normalIndices;
+      };
+
+      uint32_t workerCount(std::size_t size) {
+        const std::size_t threads = JobSystem::get().getThreadCount();
+        return (uint32_t)std::clamp<std::size_t>(size / MIN_CHUNK_SIZE, 1, threads);
+      }
+
+      // Run `work(first, last)` over at most `workers` contiguous ranges of [0, count), on the
+      // job system
+      template <typename Work> void parallelFor(std::size_t count, uint32_t workers, Work work) {
+        workers = (uint32_t)std::clamp<std::size_t>(count, 1, workers);
+        JobSystem::get().parallelFor(count, (count + workers - 1) / workers, work);
+      }
+
+      // Run `work(index)` for every index of [0, count), each as its own job
+      template <typename Work> void parallelEach(std::size_t count, Work work) {
+        parallelFor(count, count, [&work](std::size_t first, std::size_t last) {
+          for (std::size_t index = first; index < last; index++) work(index);
+        });
+      }
+
+      // Bounds of at most `workers` chunks of [begin, end), each one ending on a line end
+      std::vector<const char*> splitLines(const char* begin, const char* end, uint32_t workers) {
+        std::vector<const char*> bounds{begin};
+        for (uint32_t worker = 1; worker < workers; worker++) {
+          const char* split = std::max(begin + (end - begin) * worker / workers, bounds.back());
+          const char* newline = (const char*)std::memchr(split, '\n', end - split);
+          bounds.push_back(newline ? newline + 1 : end);
+        }
+        bounds.push_back(end);
+
+        return bounds;
+      }
+
+      // End of the `count` lines starting at `begin`, or nullptr when the data is shorter
+      const char* skipLines(const char* begin, const char* end, std::size_t count) {
+        for (; count > 0; count--) {
+          const char* newline = (const char*)std::memchr(begin, '\n', end - begin);
+          if (!newline) return count == 1 && begin < end ? end : nullptr;
+          begin = newline + 1;
+        }
+        return begin;
+      }
+
+      template <typename Parse> void forEachLine(const char* begin, const char* end, Parse parse) {
+        while (begin < end) {
+          const char* newline = (const char*)std::memchr(begin, '\n', end - begin);
+          const char* lineEnd = newline ? newline : end;
+          parse(begin, lineEnd);
+          begin = lineEnd + 1;
+        }
+      }
+
+      inline bool isSpace(char c) { return c == ' ' || c == '\t' || c == '\r'; }
+
+      inline const char* skipSpaces(const char* p, const char* end) {
+        while (p < end && isSpace(*p)) p++;
+        return p;
+      }
+
+      inline bool isDigit(char c) { return (unsigned)(c - '0') < 10; }
+
+      // Decimal number, from_chars style: returns the end of the number or nullptr when there is
+      // none. The mantissa is exact up to 18 digits, further digits only scale it.
+      const char* parseNumber(const char* p, const char* end, double& value) {
+        static constexpr double POWERS[] = {1e0,  1e1,  1e2,  1e3,  1e4,  1e5,  1e6,  1e7,
+                                            1e8,  1e9,  1e10, 1e11, 1e12, 1e13, 1e14, 1e15,
+                                            1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22};
+        constexpr uint64_t MAX_MANTISSA = 100000000000000000ull;
+
+        p = skipSpaces(p, end);
+
+        bool negative = false;
+        if (p < end && (*p == '-' || *p == '+')) negative = *p++ == '-';
+
+        uint64_t mantissa = 0;
+        int32_t exponent = 0, digits = 0;
+        for (; p < end && isDigit(*p); p++, digits++) {
+          if (mantissa < MAX_MANTISSA)
+            mantissa = mantissa * 10 + (*p - '0');
+          else
+            exponent++;
+        }
+
+        if (p < end && *p == '.') {
+          for (p++; p < end && isDigit(*p); p++, digits++) {
+            if (mantissa < MAX_MANTISSA) {
+              mantissa = mantissa * 10 + (*p - '0');
+              exponent--;
+            }
+          }
+        }
+
+        if (digits == 0) return nullptr;
+
+        if (p + 1 < end && (*p == 'e' || *p == 'E')) {
+          const char* power = p + 1;
+          if (*power == '+') power++;
+
+          int32_t value = 0;
+          auto [next, status] = std::from_chars(power, end, value);
+          if (status == std::errc()) {
+            exponent += value;
+            p = next;
+          }
+        }
+
+        double result = (double)mantissa;
+        if (exponent > 22 || exponent < -22)
+          result *= std::pow(10., exponent);
+        else if (exponent > 0)
+          result *= POWERS[exponent];
+        else if (exponent < 0)
+          result /= POWERS[-exponent];
+
+        value = negative ? -result : result;
+        return p;
+      }
+
+      const char* parseVec3(const char* p, const char* end, glm::vec3& value) {
+        double x, y, z;
+        if (!(p = parseNumber(p, end, x)) || !(p = parseNumber(p, end, y))
+            || !(p = parseNumber(p, end, z)))
+          return nullptr;
+
+        value = {(float)x, (float)y, (float)z};
+        return p;
+      }
+
+      std::string excerpt(const char* begin, const char* end) {
+        return std::string(begin, std::min<std::size_t>(end - begin, 40));
+      }
+
+      // ==== Wavefront OBJ ====
+
+      // Negative references are relative to the last vertex read so far, which depends on the
+      // previous chunks. They are stored biased by RELATIVE until these are counted.
+      constexpr int64_t RELATIVE = int64_t(1) << 62;
+      constexpr int64_t NO_REFERENCE = -1;
+
+      struct ObjChunk {
+        std::vector<glm::vec3> positions, normals;
+        std::vector<int64_t> positionReferences, normalReferences;
+        bool missingNormals = false;
+        std::string error;
+
+        // Offsets of the chunk in the whole file
+        std::size_t firstPosition = 0, firstNormal = 0, firstCorner = 0;
+      };
+
+      // 1-based absolute references become 0-based, relative ones stay relative to the chunk
+      inline int64_t objReference(int64_t value, std::size_t chunkCount) {
+        return value > 0 ? value - 1 : RELATIVE + (int64_t)chunkCount + value;
+      }
+
+      void parseObjChunk(ObjChunk& chunk, const char* begin, const char* end) {
+        std::vector<int64_t> face, faceNormals;
+
+        forEachLine(begin, end, [&](const char* line, const char* lineEnd) {
+          if (!chunk.error.empty()) return;
+
+          const char* p = skipSpaces(line, lineEnd);
+          if (lineEnd - p < 2) return;
+
+          if (p[0] == 'v' && isSpace(p[1])) {
+            glm::vec3 position;
+            if (!parseVec3(p + 1, lineEnd, position)) {
+              chunk.error = fmt::format("Malformed vertex \"{}\"", excerpt(line, lineEnd));
+              return;
+            }
+            chunk.positions.push_back(position);
+          } else if (p[0] == 'v' && p[1] == 'n' && lineEnd - p > 2 && isSpace(p[2])) {
+            glm::vec3 normal;
+            if (!parseVec3(p + 2, lineEnd, normal)) {
+              chunk.error = fmt::format("Malformed normal \"{}\"", excerpt(line, lineEnd));
+              return;
+            }
+            chunk.normals.push_back(normal);
+          } else if (p[0] == 'f' && isSpace(p[1])) {
+            face.clear();
+            faceNormals.clear();
+
+            // Corners are v, v/vt, v//vn or v/vt/vn, texture coordinates are ignored
+            for (p = skipSpaces(p + 1, lineEnd); p < lineEnd; p = skipSpaces(p, lineEnd)) {
+              int64_t position = 0, texture = 0, normal = 0;
+              bool hasNormal = false;
+
+              auto [next, status] = std::from_chars(p, lineEnd, position);
+              bool valid = status == std::errc() && position != 0;
+              p = next;
+
+              if (valid && p < lineEnd && *p == '/') {
+                if (++p < lineEnd && *p != '/') {
+                  auto [next, status] = std::from_chars(p, lineEnd, texture);
+                  valid = status == std::errc();
+                  p = next;
+                }
+                if (valid && p < lineEnd && *p == '/') {
+                  auto [next, status] = std::from_chars(p + 1, lineEnd, normal);
+                  valid = status == std::errc() && normal != 0;
+                  hasNormal = true;
+                  p = next;
+                }
+              }
+
+              if (!valid || (p < lineEnd && !isSpace(*p))) {
+                chunk.error = fmt::format("Malformed face \"{}\"", excerpt(line, lineEnd));
+                return;
+              }
+
+              face.push_back(objReference(position, chunk.positions.size()));
+              faceNormals.push_back(hasNormal ? objReference(normal, chunk.normals.size())
+                                              : NO_REFERENCE);
+              chunk.missingNormals |= !hasNormal;
+            }
+
+            if (face.size() < 3) {
+              chunk.error = fmt::format("Face with less than 3 corners \"{}\"",
+                                        excerpt(line, lineEnd));
+              return;
+            }
+
+            // Fan triangulation, exact for the convex polygons exporters write
+            for (std::size_t i = 1; i + 1 < face.size(); i++) {
+              for (std::size_t corner : {std::size_t(0), i, i + 1}) {
+                chunk.positionReferences.push_back(face[corner]);
+                chunk.normalReferences.push_back(faceNormals[corner]);
+              }
+            }
+          }
+        });
+      }
+
+      // Absolute index of a reference, false when it points outside of [0, count)
+      inline bool resolveObjReference(int64_t reference, std::size_t chunkFirst, std::size_t count,
+                                      uint32_t& index) {
+        if (reference >= RELATIVE / 2) reference = reference - RELATIVE + (int64_t)chunkFirst;
+        if (reference < 0 || reference >= (int64_t)count) return false;
+
+        index = (uint32_t)reference;
+        return true;
+      }
+
+      bool importObj(const MappedFile& file, RawMesh& raw, std::string& error) {
+        const uint32_t workers = workerCount(file.size());
+        const std::vector<const char*> bounds = splitLines(file.begin(), file.end(), workers);
+
+        std::vector<ObjChunk> chunks(bounds.size() - 1);
+        parallelEach(chunks.size(),
+                     [&](std::size_t c) { parseObjChunk(chunks[c], bounds[c], bounds[c + 1]); });
+
+        // Chunk offsets, the references of each chunk can then be resolved independently
+        std::size_t positionCount = 0, normalCount = 0, cornerCount = 0;
+        bool hasNormals = true;
+        for (ObjChunk& chunk : chunks) {
+          if (!chunk.error.empty()) {
+            error = chunk.error;
+            return false;
+          }
+
+          chunk.firstPosition = positionCount;
+          chunk.firstNormal = normalCount;
+          chunk.firstCorner = cornerCount;
+          positionCount += chunk.positions.size();
+          normalCount += chunk.normals.size();
+          cornerCount += chunk.positionReferences.size();
+          hasNormals &= !chunk.missingNormals;
+        }
+
+        // Faces without normals anywhere means the normals are computed for the whole mesh
+        hasNormals &= normalCount > 0;
+
+        if (positionCount >= NO_VERTEX) {
+          error = "Too many vertices for 32 bit indices";
+          return false;
+        }
+
+        raw.positionIndices.resize(cornerCount);
+        if (hasNormals) raw.normalIndices.resize(cornerCount);
+
+        parallelEach(chunks.size(), [&](std::size_t c) {
+          ObjChunk& chunk = chunks[c];
+          for (std::size_t i = 0; i < chunk.positionReferences.size(); i++) {
+            const std::size_t corner = chunk.firstCorner + i;
+            bool valid = resolveObjReference(chunk.positionReferences[i], chunk.firstPosition,
+                                             positionCount, raw.positionIndices[corner]);
+            if (valid && hasNormals) {
+              valid = resolveObjReference(chunk.normalReferences[i], chunk.firstNormal,
+                                          normalCount, raw.normalIndices[corner]);
+            }
+
+            if (!valid) {
+              chunk.error = "Face referencing a vertex or normal that doesn't exist";
+              break;
+            }
+          }
+        });
+
+        raw.positions.reserve(positionCount);
+        raw.normals.reserve(hasNormals ? normalCount : 0);
+        for (ObjChunk& chunk : chunks) {
+          if (!chunk.error.empty()) {
+            error = chunk.error;
+            return false;
+          }
+
+          raw.positions.insert(raw.positions.end(), chunk.positions.begin(), chunk.positions.end());
+          if (hasNormals)
+            raw.normals.insert(raw.normals.end(), chunk.normals.begin(), chunk.normals.end());
+        }
+
+        return true;
+      }
+
+      // ==== Stanford PLY ====
+
+      enum class PlyType { NONE, INT8, UINT8, INT16, UINT16, INT32, UINT32, FLOAT32, FLOAT64 };
+
+      struct PlyProperty {
+        std::string name;
+        PlyType type;
+        PlyType countType = PlyType::NONE;  // Lists only, `type` is then the type of the items
+      };
+
+      struct PlyElement {
+        std::string name;
+        std::size_t count;
+        std::vector<PlyProperty> properties;
+
+        inline bool hasLists() const {
+          return std::any_of(properties.begin(), properties.end(),
+                             [](const PlyProperty& p) { return p.countType != PlyType::NONE; });
+        }
+
+        inline int32_t find(std::string_view name) const {
+          for (std::size_t i = 0; i < properties.size(); i++)
+            if (properties[i].name == name) return (int32_t)i;
+          return -1;
+        }
+      };
+
+      enum class PlyFormat { ASCII, BINARY_LITTLE_ENDIAN, BINARY_BIG_ENDIAN };
+
+      struct PlyHeader {
+        PlyFormat format = PlyFormat::ASCII;
+        std::vector<PlyElement> elements;
+        const char* body;
+      };
+
+      PlyType plyType(std::string_view name) {
+        static const std::unordered_map<std::string_view, PlyType> TYPES = {
+            {"char", PlyType::INT8},       {"int8", PlyType::INT8},
+            {"uchar", PlyType::UINT8},     {"uint8", PlyType::UINT8},
+            {"short", PlyType::INT16},     {"int16", PlyType::INT16},
+            {"ushort", PlyType::UINT16},   {"uint16", PlyType::UINT16},
+            {"int", PlyType::INT32},       {"int32", PlyType::INT32},
+            {"uint", PlyType::UINT32},     {"uint32", PlyType::UINT32},
+            {"float", PlyType::FLOAT32},   {"float32", PlyType::FLOAT32},
+            {"double", PlyType::FLOAT64},  {"float64", PlyType::FLOAT64},
+        };
+
+        auto type = TYPES.find(name);
+        return type == TYPES.end() ? PlyType::NONE : type->second;
+      }
+
+      uint32_t plySize(PlyType type) {
+        switch (type) {
+          case PlyType::INT8:
+          case PlyType::UINT8:
+            return 1;
+          case PlyType::INT16:
+          case PlyType::UINT16:
+            return 2;
+          case PlyType::INT32:
+          case PlyType::UINT32:
+          case PlyType::FLOAT32:
+            return 4;
+          case PlyType::FLOAT64:
+            return 8;
+          case PlyType::NONE:
+            break;
+        }
+        return 0;
+      }
+
+      template <typename T> double readAs(const uint8_t* bytes) {
+        T value;
+        std::memcpy(&value, bytes, sizeof(T));
+        return (double)value;
+      }
+
+      double readBinary(const char* p, PlyType type, bool swap) {
+        uint8_t bytes[8];
+        const uint32_t size = plySize(type);
+        std::memcpy(bytes, p, size);
+        if (swap) std::reverse(bytes, bytes + size);
+
+        switch (type) {
+          case PlyType::INT8:
+            return readAs<int8_t>(bytes);
+          case PlyType::UINT8:
+            return readAs<uint8_t>(bytes);
+          case PlyType::INT16:
+            return readAs<int16_t>(bytes);
+          case PlyType::UINT16:
+            return readAs<uint16_t>(bytes);
+          case PlyType::INT32:
+            return readAs<int32_t>(bytes);
+          case PlyType::UINT32:
+            return readAs<uint32_t>(bytes);
+          case PlyType::FLOAT32:
+            return readAs<float>(bytes);
+          case PlyType::FLOAT64:
+            return readAs<double>(bytes);
+          case PlyType::NONE:
+            break;
+        }
+        return 0.;
+      }
+
+      std::vector<std::string_view> splitWords(const char* begin, const char* end) {
+        std::vector<std::string_view> words;
+        for (const char* p = skipSpaces(begin, end); p < end; p = skipSpaces(p, end)) {
+          const char* word = p;
+          while (p < end && !isSpace(*p)) p++;
+          words.emplace_back(word, p - word);
+        }
+        return words;
+      }
+
+      bool parsePlyHeader(const MappedFile& file, PlyHeader& header, std::string& error) {
+        const char* p = file.begin();
+        const char* end = file.end();
+
+        for (uint32_t line = 0; p < end; line++) {
+          const char* newline = (const char*)std::memchr(p, '\n', end - p);
+          const char* lineEnd = newline ? newline : end;
+          const std::vector<std::string_view> words = splitWords(p, lineEnd);
+          p = lineEnd + 1;
+
+          if (line == 0) {
+            if (words.size() != 1 || words[0] != "ply") break;
+          } else if (words.empty() || words[0] == "comment" || words[0] == "obj_info") {
+            continue;
+          } else if (words[0] == "format" && words.size() == 3) {
+            if (words[1] == "ascii")
+              header.format = PlyFormat::ASCII;
+            else if (words[1] == "binary_little_endian")
+              header.format = PlyFormat::BINARY_LITTLE_ENDIAN;
+            else if (words[1] == "binary_big_endian")
+              header.format = PlyFormat::BINARY_BIG_ENDIAN;
+            else
+              break;
+          } else if (words[0] == "element" && words.size() == 3) {
+            std::size_t count = 0;
+            const char* digits = words[2].data();
+            auto [next, status] = std::from_chars(digits, digits + words[2].size(), count);
+            if (status != std::errc()) break;
+
+            header.elements.push_back({std::string(words[1]), count, {}});
+          } else if (words[0] == "property" && !header.elements.empty()) {
+            PlyProperty property;
+            if (words.size() == 3) {
+              property = {std::string(words[2]), plyType(words[1])};
+            } else if (words.size() == 5 && words[1] == "list") {
+              property = {std::string(words[4]), plyType(words[3]), plyType(words[2])};
+              if (property.countType == PlyType::NONE) break;
+            } else {
+              break;
+            }
+
+            if (property.type == PlyType::NONE) break;
+            header.elements.back().properties.push_back(property);
+          } else if (words[0] == "end_header") {
+            header.body = std::min(p, end);
+            return true;
+          } else {
+            break;
+          }
+        }
+
+        error = "Invalid PLY header";
+        return false;
+      }
+
+      // Size of a binary record without lists
+      uint32_t plyStride(const PlyElement& element) {
+        uint32_t stride = 0;
+        for (const PlyProperty& property : element.properties) stride += plySize(property.type);
+        return stride;
+      }
+
+      struct PlyVertexProperties {
+        int32_t x, y, z, nx, ny, nz;
+
+        inline bool hasNormals() const { return nx >= 0 && ny >= 0 && nz >= 0; }
+      };
+
+      // Store the attributes of one vertex record, given the value of each of its properties
+      template <typename Value>
+      void storePlyVertex(const PlyVertexProperties& properties, RawMesh& raw, std::size_t vertex,
+                          Value value) {
+        raw.positions[vertex] = {value(properties.x), value(properties.y), value(properties.z)};
+        if (properties.hasNormals())
+          raw.normals[vertex] = {value(properties.nx), value(properties.ny), value(properties.nz)};
+      }
+
+      // Append the fan triangulation of a polygon
+      template <typename Index>
+      void appendPolygon(std::vector<uint32_t>& indices, std::size_t corners, Index index) {
+        for (std::size_t i = 1; i + 1 < corners; i++) {
+          indices.push_back(index(0));
+          indices.push_back(index(i));
+          indices.push_back(index(i + 1));
+        }
+      }
+
+      bool importPly(const MappedFile& file, RawMesh& raw, std::string& error) {
+        PlyHeader header;
+        if (!parsePlyHeader(file, header, error)) return false;
+
+        const uint16_t probe = 1;
+        const bool littleEndianHost = *(const uint8_t*)&probe == 1;
+        const bool ascii = header.format == PlyFormat::ASCII;
+        const bool swap = !ascii
+                          && littleEndianHost
+                                 != (header.format == PlyFormat::BINARY_LITTLE_ENDIAN);
+
+        const char* p = header.body;
+        const char* end = file.end();
+        bool hasVertices = false;
+
+        auto truncated = [&]() {
+          error = "Truncated PLY file";
+          return false;
+        };
+
+        for (const PlyElement& element : header.elements) {
+          if (element.name == "vertex") {
+            const PlyVertexProperties properties{element.find("x"),  element.find("y"),
+                                                 element.find("z"),  element.find("nx"),
+                                                 element.find("ny"), element.find("nz")};
+            if (properties.x < 0 || properties.y < 0 || properties.z < 0) {
+              error = "PLY vertices without x, y and z";
+              return false;
+            }
+            if (element.hasLists()) {
+              error = "PLY vertices with list properties are not supported";
+              return false;
+            }
+            if (element.count >= NO_VERTEX) {
+              error = "Too many vertices for 32 bit indices";
+              return false;
+            }
+
+            raw.positions.resize(element.count);
+            if (properties.hasNormals()) raw.normals.resize(element.count);
+            hasVertices = true;
+
+            if (ascii) {
+              // One vertex per line: chunks of lines, each knowing the index of its first vertex
+              const char* last = skipLines(p, end, element.count);
+              if (!last) return truncated();
+
+              const std::vector<const char*> bounds
+                  = splitLines(p, last, workerCount(last - p));
+              const std::size_t chunks = bounds.size() - 1;
+              std::vector<std::size_t> firstVertex(chunks + 1, 0);
+              std::vector<uint8_t> failed(chunks, false);
+
+              parallelEach(chunks, [&](std::size_t c) {
+                std::size_t lines = 0;
+                forEachLine(bounds[c], bounds[c + 1], [&](const char*, const char*) { lines++; });
+                firstVertex[c + 1] = lines;
+              });
+              std::partial_sum(firstVertex.begin(), firstVertex.end(), firstVertex.begin());
+
+              parallelEach(chunks, [&](std::size_t c) {
+                std::vector<double> values(element.properties.size());
+                std::size_t vertex = firstVertex[c];
+
+                forEachLine(bounds[c], bounds[c + 1], [&](const char* line, const char* lineEnd) {
+                  for (double& value : values) {
+                    if (!line || !(line = parseNumber(line, lineEnd, value))) failed[c] = true;
+                  }
+                  if (failed[c]) return;
+
+                  storePlyVertex(properties, raw, vertex++,
+                                 [&](int32_t property) { return (float)values[property]; });
+                });
+              });
+
+              if (std::find(failed.begin(), failed.end(), true) != failed.end()) {
+                error = "Malformed PLY vertex";
+                return false;
+              }
+              p = last;
+            } else {
+              // Fixed size records, every thread reads its own range in place
+              std::vector<uint32_t> offsets;
+              uint32_t stride = 0;
+              for (const PlyProperty& property : element.properties) {
+                offsets.push_back(stride);
+                stride += plySize(property.type);
+              }
+
+              if ((std::size_t)(end - p) < element.count * stride) return truncated();
+
+              parallelFor(element.count, workerCount(element.count * stride),
+                          [&](std::size_t first, std::size_t last) {
+                            for (std::size_t vertex = first; vertex < last; vertex++) {
+                              const char* record = p + vertex * stride;
+                              storePlyVertex(properties, raw, vertex, [&](int32_t property) {
+                                return (float)readBinary(record + offsets[property],
+                                                         element.properties[property].type,
+                                                         swap);
+                              });
+                            }
+                          });
+              p += element.count * stride;
+            }
+          } else if (element.name == "face") {
+            int32_t indexList = element.find("vertex_indices");
+            if (indexList < 0) indexList = element.find("vertex_index");
+            if (indexList < 0 || element.properties[indexList].countType == PlyType::NONE) {
+              error = "PLY faces without a vertex_indices list";
+              return false;
+            }
+
+            if (ascii) {
+              const char* last = skipLines(p, end, element.count);
+              if (!last) return truncated();
+
+              // Chunks of faces, concatenated in order once parsed
+              const std::vector<const char*> bounds
+                  = splitLines(p, last, workerCount(last - p));
+              std::vector<std::vector<uint32_t>> chunks(bounds.size() - 1);
+              std::vector<uint8_t> failed(chunks.size(), false);
+
+              parallelEach(chunks.size(), [&](std::size_t c) {
+                std::vector<uint32_t> polygon;
+
+                forEachLine(bounds[c], bounds[c + 1], [&](const char* line, const char* lineEnd) {
+                  for (std::size_t i = 0; line && i < element.properties.size(); i++) {
+                    double value = 0.;
+                    if (element.properties[i].countType == PlyType::NONE) {
+                      line = parseNumber(line, lineEnd, value);
+                      continue;
+                    }
+
+                    if (!(line = parseNumber(line, lineEnd, value))) break;
+                    const std::size_t count = (std::size_t)value;
+
+                    polygon.clear();
+                    for (std::size_t item = 0; line && item < count; item++) {
+                      line = parseNumber(line, lineEnd, value);
+                      polygon.push_back((uint32_t)value);
+                    }
+                    if (line && (int32_t)i == indexList)
+                      appendPolygon(chunks[c], count, [&](std::size_t k) { return polygon[k]; });
+                  }
+                  if (!line) failed[c] = true;
+                });
+              });
+
+              if (std::find(failed.begin(), failed.end(), true) != failed.end()) {
+                error = "Malformed PLY face";
+                return false;
+              }
+
+              for (const std::vector<uint32_t>& chunk : chunks)
+                raw.positionIndices.insert(raw.positionIndices.end(), chunk.begin(), chunk.end());
+              p = last;
+            } else {
+              // Variable size records, read in order
+              raw.positionIndices.reserve(element.count * 3);
+
+              for (std::size_t face = 0; face < element.count; face++) {
+                for (std::size_t i = 0; i < element.properties.size(); i++) {
+                  const PlyProperty& property = element.properties[i];
+                  std::size_t count = 1;
+
+                  if (property.countType != PlyType::NONE) {
+                    if ((std::size_t)(end - p) < plySize(property.countType)) return truncated();
+                    count = (std::size_t)readBinary(p, property.countType, swap);
+                    p += plySize(property.countType);
+                  }
+
+                  const uint32_t size = plySize(property.type);
+                  if ((std::size_t)(end - p) < count * size) return truncated();
+
+                  if ((int32_t)i == indexList) {
+                    appendPolygon(raw.positionIndices, count, [&](std::size_t k) {
+                      return (uint32_t)readBinary(p + k * size, property.type, swap);
+                    });
+                  }
+                  p += count * size;
+                }
+              }
+            }
+          } else if (ascii) {
+            // Anything else (edges, materials...) is skipped
+            if (!(p = skipLines(p, end, element.count))) return truncated();
+          } else if (!element.hasLists()) {
+            const std::size_t size = element.count * plyStride(element);
+            if ((std::size_t)(end - p) < size) return truncated();
+            p += size;
+          } else {
+            for (std::size_t record = 0; record < element.count; record++) {
+              for (const PlyProperty& property : element.properties) {
+                std::size_t count = 1;
+                if (property.countType != PlyType::NONE) {
+                  if ((std::size_t)(end - p) < plySize(property.countType)) return truncated();
+                  count = (std::size_t)readBinary(p, property.countType, swap);
+                  p += plySize(property.countType);
+                }
+
+                if ((std::size_t)(end - p) < count * plySize(property.type)) return truncated();
+                p += count * plySize(property.type);
+              }
+            }
+          }
+        }
+
+        if (!hasVertices) {
+          error = "PLY file without vertices";
+          return false;
+        }
+
+        for (uint32_t index : raw.positionIndices) {
+          if (index >= raw.positions.size()) {
+            error = "PLY face referencing a vertex that doesn't exist";
+            return false;
+          }
+        }
+
+        return true;
+      }
+
+      // ==== Welding and packing ====
+
+      bool buildMesh(const RawMesh& raw, ImportedMesh& mesh, std::string& error) {
+        if (raw.positionIndices.empty()) {
+          error = "The file has no faces";
+          return false;
+        }
+
+        // Output vertices, as the position (and normal) they are made of
+        std::vector<uint32_t> vertexPositions, vertexNormals;
+        std::vector<uint32_t>& indices = mesh.indices;
+        indices.resize(raw.positionIndices.size());
+
+        if (!raw.normalIndices.empty()) {
+          // A vertex per distinct (position, normal) pair
+          std::unordered_map<uint64_t, uint32_t> welded;
+          welded.reserve(raw.positions.size() + raw.positions.size() / 2);
+
+          for (std::size_t corner = 0; corner < indices.size(); corner++) {
+            const uint32_t position = raw.positionIndices[corner];
+            const uint32_t normal = raw.normalIndices[corner];
+            const uint64_t key = (uint64_t)position << 32 | normal;
+
+            auto [it, inserted] = welded.try_emplace(key, (uint32_t)vertexPositions.size());
+            if (inserted) {
+              vertexPositions.push_back(position);
+              vertexNormals.push_back(normal);
+            }
+            indices[corner] = it->second;
+          }
+        } else {
+          // Normals (if any) follow the positions, only unused positions are dropped
+          std::vector<uint32_t> remap(raw.positions.size(), NO_VERTEX);
+
+          for (std::size_t corner = 0; corner < indices.size(); corner++) {
+            const uint32_t position = raw.positionIndices[corner];
+            if (remap[position] == NO_VERTEX) {
+              remap[position] = vertexPositions.size();
+              vertexPositions.push_back(position);
+            }
+            indices[corner] = remap[position];
+          }
+
+          if (!raw.normals.empty()) vertexNormals = vertexPositions;
+        }
+
+        const std::size_t vertexCount = vertexPositions.size();
+        std::vector<glm::vec3> normals(vertexCount, glm::vec3{0.f});
+
+        if (vertexNormals.empty()) {
+          // Area weighted average of the faces around every vertex
+          for (std::size_t corner = 0; corner + 2 < indices.size(); corner += 3) {
+            const uint32_t a = indices[corner], b = indices[corner + 1], c = indices[corner + 2];
+            const glm::vec3& pa = raw.positions[vertexPositions[a]];
+            const glm::vec3 normal = glm::cross(raw.positions[vertexPositions[b]] - pa,
+                                                raw.positions[vertexPositions[c]] - pa);
+            normals[a] += normal;
+            normals[b] += normal;
+            normals[c] += normal;
+          }
+        } else {
+          for (std::size_t vertex = 0; vertex < vertexCount; vertex++)
+            normals[vertex] = raw.normals[vertexNormals[vertex]];
+        }
+
+        glm::vec3 min{std::numeric_limits<float>::max()}, max{-std::numeric_limits<float>::max()};
+        for (uint32_t position : vertexPositions) {
+          min = glm::min(min, raw.positions[position]);
+          max = glm::max(max, raw.positions[position]);
+        }
+
+        const glm::vec3 halfSize = (max - min) * .5f;
+        mesh.center = (min + max) * .5f;
+        mesh.extent = std::max({halfSize.x, halfSize.y, halfSize.z});
+        if (mesh.extent <= 0.f) mesh.extent = 1.f;
+        mesh.bounds = {(min - mesh.center) / mesh.extent, (max - mesh.center) / mesh.extent};
+
+        mesh.vertices.resize(vertexCount);
+        parallelFor(vertexCount, workerCount(vertexCount * sizeof(ImportedVertex)),
+                    [&](std::size_t first, std::size_t last) {
+                      for (std::size_t vertex = first; vertex < last; vertex++) {
+                        const glm::vec3 position
+                            = (raw.positions[vertexPositions[vertex]] - mesh.center) / mesh.extent;
+                        const float length = glm::length(normals[vertex]);
+                        const glm::vec3 normal
+                            = length > 0.f ? normals[vertex] / length : glm::vec3{0.f, 0.f, 1.f};
+
+                        ImportedVertex& packed = mesh.vertices[vertex];
+                        packed.position
+                            = {pack::snorm16(position.x), pack::snorm16(position.y),
+                               pack::snorm16(position.z), pack::snorm16(1.f)};
+                        packed.normal = packed.faceNormal = pack::snorm1010102(normal);
+                      }
+                    });
+
+        return true;
+      }
+    }  // namespace
+
+    bloom::VertexBufferLayout ImportedMesh::getLayout() {
+      bloom::VertexBufferLayout layout;
+      layout
+          .push<int16_t>(4, true)         // Position          x, y, z, w
+          .push<Packed1010102>(4, true)   // Normal            nx, ny, nz
+          .push<Packed1010102>(4, true);  // Face normal       nx, ny, nz
+
+      return layout;
+    }
+
+    bool importMesh(const std::filesystem::path& path, ImportedMesh& mesh, std::string& error) {
+      const MappedFile file(path);
+      if (!file.isOpen()) {
+        error = fmt::format("Can't open \"{}\"", path.string());
+        return false;
+      }
+
+      std::string extension = path.extension().string();
+      std::transform(extension.begin(), extension.end(), extension.begin(),
+                     [](char c) { return (char)std::tolower(c); });
+
+      RawMesh raw;
+      if (extension == ".obj") {
+        if (!importObj(file, raw, error)) return false;
+      } else if (extension == ".ply") {
+        if (!importPly(file, raw, error)) return false;
+      } else {
+        error = fmt::format("Unsupported mesh format \"{}\" (.obj and .ply are)", extension);
+        return false;
+      }
+
+      return buildMesh(raw, mesh, error);
+    }
+  }  // namespace io
+}  // namespace bloom
@@ -0,0 +1,77 @@
+#include <bloomCG/core/core.hpp>
+#include <bloomCG/io/mapped_file.hpp>
+#include <bloomCG/io/mesh_cache.hpp>
+#include <bloomCG/io/mesh_importer.hpp>
+#include <bloomCG/models/imported_model.hpp>
+#include <bloomCG/models/mesh_optimizer.hpp>
+
+namespace bloom {
+  std::shared_ptr<bloom::Mesh> Model::loadMesh(const std::filesystem::path& path,
+                                               std::string& error) {
+    // Different spellings of the same file share the mesh
+    std::error_code status;
+    const std::filesystem::path canonical = std::filesystem::weakly_canonical(path, status);
+    const std::string key = (status ? path : canonical).string();
+
+    auto build = [&]() -> std::shared_ptr<bloom::Mesh> {
+      // Hashing the mapped source is much cheaper than parsing it, an edited file gets a new
+      // hash and is imported again
+      uint64_t sourceHash = 0;
+      {
+        io::MappedFile source(path);
+        if (source.isOpen())
+          sourceHash = io::hashBytes(source.begin(), source.size(), io::IMPORTER_VERSION);
+      }
+
+      const std::string cacheName
+          = fmt::format("model-{:016x}", io::hashBytes(key.data(), key.size()));
+      MeshData data;
+      if (sourceHash != 0 && io::MeshCache::load(cacheName, sourceHash, data))
+        return std::make_shared<bloom::Mesh>(data);
+
+      io::ImportedMesh imported;
+      if (!io::importMesh(path, imported, error)) return nullptr;
+
+      const MeshCacheStats stats = meshopt::optimize(imported.vertices, imported.indices);
+
+      data = MeshData::from(std::move(imported.vertices), io::ImportedMesh::getLayout(),
+                            std::move(imported.indices), {}, stats);
+      data.bounds = imported.bounds;
+      io::MeshCache::store(cacheName, sourceHash, data);
+
+      return std::make_shared<bloom::Mesh>(data);
+    };
+
+    return MeshRegistry::acquire(key, build);
+  }
+
+  Model::Model(std::shared_ptr<bloom::Mesh> mesh, const std::string& path, glm::vec3 position,
+               float size, glm::vec3 color)
+      : m_path(path), m_size(size), m_mesh(std::move(mesh)) {
+    setColor(color);
+    setAppliedTransformation(position);
+
+    ecs::Renderable& data = renderable();
+    data.levels[0] = {m_mesh.get(), 0};
+    data.levelCount = 1;
+    data.meshScale = glm::vec3(m_size);
+  }
+
+  float Model::getSize() { return m_size; }
+
+  void Model::setSize(float size) {
+    m_size = size;
+    renderable().meshScale = glm::vec3(m_size);
+  }
+
+  void Model::print() {
+    fmt::print("\nModel:\n");
+    fmt::print("Path: {}\n", m_path);
+    fmt::print("Size: {}\n", m_size);
+    fmt::print("Vertices: {}\n", m_mesh->getVertexCount());
+    fmt::print("Triangles: {}\n", m_mesh->getTriangleCount());
+    fmt::print("ACMR: {:.3f} (was {:.3f})\n", m_mesh->getCacheStats().acmrAfter,
+               m_mesh->getCacheStats().acmrBefore);
+    fmt::print("Mesh users: {}\n", m_mesh.use_count());
+  }
+}  // namespace bloom
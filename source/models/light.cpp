@@ -1,51 +1,72 @@
 #include <bloomCG/models/light.hpp>
 
 namespace bloom {
-  Light::Light(glm::vec3 position) : Sphere(position) {}
+  // Gizmos are icospheres, their whole LOD chain is a single mesh
+  Light::Light(glm::vec3 position) : Sphere(position) { setType(Type::ICOSPHERE); }
 
-  AmbientLight::AmbientLight(glm::vec3 ambientIntensity) : m_ambientIntensity(ambientIntensity) {}
+  AmbientLight::AmbientLight(glm::vec3 ambientIntensity) {
+    ecs::registry.emplace<ecs::AmbientLight>(m_entity, ambientIntensity);
+  }
 
   AmbientLight* AmbientLight::setIntensity(const glm::vec3& ambientIntensity) {
-    m_ambientIntensity = ambientIntensity;
+    ecs::registry.get<ecs::AmbientLight>(m_entity).intensity = ambientIntensity;
     return this;
   }
 
-  glm::vec3 AmbientLight::getIntensity() const { return m_ambientIntensity; }
+  glm::vec3 AmbientLight::getIntensity() const {
+    return ecs::registry.get<ecs::AmbientLight>(m_entity).intensity;
+  }
 
   glm::vec3 AmbientLight::getPosition() { return (glm::vec3)0; };
   void AmbientLight::setPosition(glm::vec3 position) {}
 
   PointLight::PointLight(glm::vec3 position, glm::vec3 intensity, float constant, float linear,
                          float quadratic)
-      : Light(position),
-        m_intensity(intensity),
-        m_constant(constant),
-        m_linear(linear),
-        m_quadratic(quadratic) {}
+      : Light(position) {
+    ecs::registry.emplace<ecs::PointLight>(m_entity, intensity, constant, linear, quadratic);
+  }
 
   PointLight* PointLight::setIntensity(const glm::vec3& intensity) {
-    m_intensity = intensity;
+    ecs::registry.get<ecs::PointLight>(m_entity).intensity = intensity;
     return this;
   }
 
   PointLight* PointLight::setConstant(const float& constant) {
-    m_constant = constant;
+    ecs::registry.get<ecs::PointLight>(m_entity).constant = constant;
     return this;
   }
 
   PointLight* PointLight::setLinear(const float& linear) {
-    m_linear = linear;
+    ecs::registry.get<ecs::PointLight>(m_entity).linear = linear;
     return this;
   }
 
   PointLight* PointLight::setQuadratic(const float& quadratic) {
-    m_quadratic = quadratic;
+    ecs::registry.get<ecs::PointLight>(m_entity).quadratic = quadratic;
     return this;
   }
 
-  glm::vec3 PointLight::getIntensity() const { return m_intensity; }
+  glm::vec3 PointLight::getIntensity() const {
+    return ecs::registry.get<ecs::PointLight>(m_entity).intensity;
+  }
 
-  float PointLight::getConstant() const { return m_constant; }
-  float PointLight::getLinear() const { return m_linear; }
-  float PointLight::getQuadratic() const { return m_quadratic; }
+  float PointLight::getConstant() const {
+    return ecs::registry.get<ecs::PointLight>(m_entity).constant;
+  }
+  float PointLight::getLinear() const {
+    return ecs::registry.get<ecs::PointLight>(m_entity).linear;
+  }
+  float PointLight::getQuadratic() const {
+    return ecs::registry.get<ecs::PointLight>(m_entity).quadratic;
+  }
+
+  PointLightData PointLight::getLightData() {
+    return getLightData(transform(), ecs::registry.get<ecs::PointLight>(m_entity));
+  }
+
+  PointLightData PointLight::getLightData(const ecs::Transform& transform,
+                                          const ecs::PointLight& light) {
+    return {transform.getWorldPosition(), light.constant, light.intensity, light.linear,
+            light.quadratic, {}};
+  }
 }  // namespace bloom
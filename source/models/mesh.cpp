@@ -0,0 +1,168 @@
+#include <bloomCG/core/core.hpp>
+#include <bloomCG/core/job_system.hpp>
+#include <bloomCG/core/renderer.hpp>
+#include <bloomCG/models/mesh.hpp>
+
+namespace bloom {
+  Mesh::Mesh(const void* vertices, uint32_t size, const bloom::VertexBufferLayout& layout,
+             const uint32_t* indices, uint32_t indexCount, const std::vector<MeshLod>& lods)
+      : m_layout(layout), m_lods(lods) {
+    ASSERT(size % layout.getStride() == 0);
+
+    m_vertexBuffer = std::make_unique<bloom::VertexBuffer>(vertices, size);
+    m_vertexCount = size / layout.getStride();
+
+    if (indexCount > 0) m_indexBuffer = std::make_unique<bloom::IndexBuffer>(indices, indexCount);
+
+    m_vertexArray = std::make_unique<bloom::VertexArray>();
+    m_vertexArray->addBuffer(*m_vertexBuffer, m_layout);
+  }
+
+  Mesh::Mesh(const MeshData& data)
+      : Mesh(data.vertices, data.vertexBytes, data.layout, data.indices, data.indexCount,
+             data.lods) {
+    m_bounds = data.bounds;
+    m_cacheStats = data.stats;
+  }
+
+  void Mesh::draw(uint32_t lod) const {
+    bind();
+    submit(1, lod);
+    unbind();
+  }
+
+  void Mesh::drawInstanced(uint32_t instanceCount, uint32_t lod) const {
+    bind();
+    submit(instanceCount, lod);
+    unbind();
+  }
+
+  void Mesh::bind() const {
+    m_vertexArray->bind();
+    if (m_indexBuffer) m_indexBuffer->bind();
+  }
+
+  void Mesh::unbind() const {
+    if (m_indexBuffer) m_indexBuffer->unbind();
+    m_vertexArray->unbind();
+  }
+
+  void Mesh::submit(uint32_t instanceCount, uint32_t lod) const {
+    bloom::Renderer::recordDraw((uint64_t)getTriangleCount(lod) * instanceCount);
+
+    if (!m_lods.empty()) {
+      const MeshLod& range = m_lods[std::min(lod, getLodCount() - 1)];
+      GLCall(glad_glDrawElementsInstanced(GL_TRIANGLES, range.indexCount, GL_UNSIGNED_INT,
+                                          (const void*)(range.firstIndex * sizeof(uint32_t)),
+                                          instanceCount));
+    } else if (m_indexBuffer) {
+      GLCall(glad_glDrawElementsInstanced(GL_TRIANGLES, m_indexBuffer->getCount(),
+                                          GL_UNSIGNED_INT, nullptr, instanceCount));
+    } else {
+      GLCall(glad_glDrawArraysInstanced(GL_TRIANGLES, 0, m_vertexCount, instanceCount));
+    }
+  }
+
+  std::unordered_map<MeshKey, std::weak_ptr<Mesh>, hash_mesh_key> MeshRegistry::s_meshes;
+
+  std::shared_ptr<Mesh> MeshRegistry::acquire(const MeshKey& key,
+                                              const std::function<std::shared_ptr<Mesh>()>& build) {
+    auto& entry = s_meshes[key];
+
+    if (auto mesh = entry.lock()) return mesh;
+
+    auto mesh = build();
+    entry = mesh;
+
+    return mesh;
+  }
+
+  std::unordered_map<std::string, std::weak_ptr<Mesh>> MeshRegistry::s_files;
+
+  std::shared_ptr<Mesh> MeshRegistry::acquire(const std::string& path,
+                                              const std::function<std::shared_ptr<Mesh>()>& build) {
+    auto& entry = s_files[path];
+
+    if (auto mesh = entry.lock()) return mesh;
+
+    auto mesh = build();
+    entry = mesh;
+
+    return mesh;
+  }
+
+  std::unordered_map<MeshKey, std::weak_ptr<MeshRequest>, hash_mesh_key> MeshRegistry::s_requests;
+
+  std::shared_ptr<MeshRequest> MeshRegistry::request(const MeshKey& key,
+                                                     std::function<MeshData()> generate) {
+    auto request = std::make_shared<MeshRequest>();
+    request->key = key;
+
+    if (auto mesh = s_meshes[key].lock()) {
+      request->mesh = mesh;
+      return request;
+    }
+
+    auto& pending = s_requests[key];
+    if (auto shared = pending.lock()) return shared;
+
+    std::weak_ptr<MeshRequest> owner = request;
+    request->data = JobSystem::get().submit([owner, generate = std::move(generate)]() {
+      // Superseded while queued, e.g. a slider dragged through many values
+      if (owner.expired()) return MeshData{};
+      return generate();
+    });
+    pending = request;
+
+    return request;
+  }
+
+  void MeshRegistry::update(std::size_t byteBudget) {
+    std::size_t uploaded = 0;
+
+    for (auto it = s_requests.begin(); it != s_requests.end();) {
+      auto request = it->second.lock();
+      if (!request) {
+        it = s_requests.erase(it);
+        continue;
+      }
+
+      const bool finished
+          = request->data.wait_for(std::chrono::seconds(0)) == std::future_status::ready;
+      if (!finished || (uploaded > 0 && uploaded >= byteBudget)) {
+        ++it;
+        continue;
+      }
+
+      // Built synchronously by someone else in the meantime
+      auto& entry = s_meshes[request->key];
+      if (auto mesh = entry.lock()) {
+        request->mesh = mesh;
+      } else {
+        const MeshData data = request->data.get();
+        request->mesh = std::make_shared<Mesh>(data);
+        entry = request->mesh;
+        uploaded += data.vertexBytes + data.indexCount * sizeof(uint32_t);
+      }
+
+      it = s_requests.erase(it);
+    }
+  }
+
+  std::size_t MeshRegistry::getMeshCount() {
+    // Forget about the meshes nobody references anymore
+    auto prune = [](auto& meshes) {
+      for (auto it = meshes.begin(); it != meshes.end();) {
+        if (it->second.expired())
+          it = meshes.erase(it);
+        else
+          ++it;
+      }
+    };
+
+    prune(s_meshes);
+    prune(s_files);
+
+    return s_meshes.size() + s_files.size();
+  }
+}  // namespace bloom
@@ -0,0 +1,193 @@
+#include <algorithm>
+#include <bloomCG/models/mesh_optimizer.hpp>
+#include <numeric>
+
+namespace bloom {
+  namespace meshopt {
+    float acmr(const std::vector<uint32_t>& indices, uint32_t first, uint32_t count,
+               uint32_t vertexCount, uint32_t cacheSize) {
+      if (count < 3) return 0.f;
+
+      // A vertex is cached while less than `cacheSize` misses happened since its own
+      std::vector<uint32_t> timestamps(vertexCount, 0);
+      uint32_t time = cacheSize + 1;
+      uint32_t misses = 0;
+
+      for (uint32_t i = first; i < first + count; i++) {
+        const uint32_t vertex = indices[i];
+        if (time - timestamps[vertex] > cacheSize) {
+          timestamps[vertex] = time++;
+          misses++;
+        }
+      }
+
+      return (float)misses / (count / 3);
+    }
+
+    void optimizeVertexCache(std::vector<uint32_t>& indices, uint32_t first, uint32_t count,
+                             uint32_t vertexCount, uint32_t cacheSize,
+                             std::vector<uint32_t>* clusters) {
+      const uint32_t triangleCount = count / 3;
+      if (triangleCount == 0) return;
+
+      const uint32_t* input = indices.data() + first;
+
+      // Triangles around every vertex, as ranges of one flat array
+      std::vector<uint32_t> live(vertexCount, 0);
+      for (uint32_t i = 0; i < count; i++) live[input[i]]++;
+
+      std::vector<uint32_t> offsets(vertexCount + 1, 0);
+      std::partial_sum(live.begin(), live.end(), offsets.begin() + 1);
+
+      std::vector<uint32_t> adjacency(count);
+      std::vector<uint32_t> filled(offsets.begin(), offsets.end() - 1);
+      for (uint32_t i = 0; i < count; i++) adjacency[filled[input[i]]++] = i / 3;
+
+      std::vector<uint32_t> timestamps(vertexCount, 0);
+      std::vector<bool> emitted(triangleCount, false);
+      std::vector<uint32_t> deadEnds;  // Recently used vertices, to restart from after a fan
+      std::vector<uint32_t> candidates;
+      std::vector<uint32_t> output;
+      output.reserve(count);
+
+      uint32_t time = cacheSize + 1;
+      uint32_t cursor = 0;  // Vertices before it have no triangle left
+      int64_t fanning = input[0];
+
+      if (clusters) clusters->push_back(0);
+
+      while (fanning >= 0) {
+        candidates.clear();
+
+        // Emit every triangle left around the fanning vertex
+        for (uint32_t a = offsets[fanning]; a < offsets[fanning + 1]; a++) {
+          const uint32_t triangle = adjacency[a];
+          if (emitted[triangle]) continue;
+
+          for (uint32_t corner = 0; corner < 3; corner++) {
+            const uint32_t vertex = input[triangle * 3 + corner];
+            output.push_back(vertex);
+            deadEnds.push_back(vertex);
+            candidates.push_back(vertex);
+            live[vertex]--;
+
+            if (time - timestamps[vertex] > cacheSize) timestamps[vertex] = time++;
+          }
+          emitted[triangle] = true;
+        }
+
+        // Next fan: the candidate that will still be cached once its remaining triangles are
+        // emitted, the oldest one first as it would be evicted soonest
+        fanning = -1;
+        int64_t best = -1;
+        for (uint32_t vertex : candidates) {
+          if (live[vertex] == 0) continue;
+
+          int64_t priority = 0;
+          if (time - timestamps[vertex] + 2 * live[vertex] <= cacheSize)
+            priority = time - timestamps[vertex];
+
+          if (priority > best) {
+            best = priority;
+            fanning = vertex;
+          }
+        }
+
+        if (fanning >= 0) continue;
+
+        // Dead end: go back to a recently used vertex, or the next one in input order
+        while (!deadEnds.empty() && fanning < 0) {
+          const uint32_t vertex = deadEnds.back();
+          deadEnds.pop_back();
+          if (live[vertex] > 0) fanning = vertex;
+        }
+
+        while (fanning < 0 && cursor < vertexCount) {
+          if (live[cursor] > 0) fanning = cursor;
+          cursor++;
+        }
+
+        if (fanning >= 0 && clusters) clusters->push_back(output.size() / 3);
+      }
+
+      std::copy(output.begin(), output.end(), indices.begin() + first);
+    }
+
+    void optimizeOverdraw(std::vector<uint32_t>& indices, uint32_t first, uint32_t count,
+                          const std::vector<uint32_t>& clusters,
+                          const std::vector<glm::vec3>& positions) {
+      const uint32_t triangleCount = count / 3;
+      if (clusters.size() < 2) return;
+
+      const uint32_t* input = indices.data() + first;
+
+      auto vertex = [&](uint32_t triangle, uint32_t corner) {
+        return positions[input[triangle * 3 + corner]];
+      };
+
+      glm::vec3 meshCenter{0.f};
+      for (uint32_t i = 0; i < count; i++) meshCenter += positions[input[i]];
+      meshCenter /= (float)count;
+
+      // Clusters whose area weighted normal points away from the center are the most likely to
+      // hide the rest of the mesh
+      struct Cluster {
+        uint32_t start, end;
+        float score;
+      };
+      std::vector<Cluster> sorted;
+      sorted.reserve(clusters.size());
+
+      for (uint32_t i = 0; i < clusters.size(); i++) {
+        const uint32_t start = clusters[i];
+        const uint32_t end = i + 1 < clusters.size() ? clusters[i + 1] : triangleCount;
+
+        glm::vec3 center{0.f}, normal{0.f};
+        float area = 0.f;
+
+        for (uint32_t triangle = start; triangle < end; triangle++) {
+          const glm::vec3 a = vertex(triangle, 0), b = vertex(triangle, 1), c = vertex(triangle, 2);
+          const glm::vec3 cross = glm::cross(b - a, c - a);
+          const float triangleArea = glm::length(cross);
+
+          center += (a + b + c) / 3.f * triangleArea;
+          normal += cross;
+          area += triangleArea;
+        }
+
+        if (area > 0.f) center /= area;
+        const float length = glm::length(normal);
+        if (length > 0.f) normal /= length;
+
+        sorted.push_back({start, end, glm::dot(center - meshCenter, normal)});
+      }
+
+      std::stable_sort(sorted.begin(), sorted.end(),
+                       [](const Cluster& a, const Cluster& b) { return a.score > b.score; });
+
+      std::vector<uint32_t> output;
+      output.reserve(count);
+      for (const Cluster& cluster : sorted)
+        output.insert(output.end(), input + cluster.start * 3, input + cluster.end * 3);
+
+      std::copy(output.begin(), output.end(), indices.begin() + first);
+    }
+
+    std::vector<uint32_t> optimizeVertexFetch(std::vector<uint32_t>& indices,
+                                              uint32_t vertexCount) {
+      constexpr uint32_t UNUSED = ~0u;
+      std::vector<uint32_t> remap(vertexCount, UNUSED);
+      uint32_t next = 0;
+
+      for (uint32_t& index : indices) {
+        if (remap[index] == UNUSED) remap[index] = next++;
+        index = remap[index];
+      }
+
+      for (uint32_t& index : remap)
+        if (index == UNUSED) index = next++;
+
+      return remap;
+    }
+  }  // namespace meshopt
+}  // namespace bloom
@@ -1,31 +1,84 @@
+#include <bloomCG/models/mesh.hpp>
 #include <bloomCG/models/model.hpp>
+#include <bloomCG/structures/transform_system.hpp>
 
 namespace bloom {
+  Entity::Entity() : m_entity(ecs::registry.create()) {}
+
+  // Nothing to do when the entity is being destroyed, and this object with it
+  Entity::~Entity() {
+    if (!ecs::registry.isAlive(m_entity)) return;
+
+    ecs::detach(m_entity);
+    ecs::registry.destroy(m_entity);
+  }
+
+  Object::Object() {
+    ecs::registry.emplace<ecs::Transform>(m_entity);
+    ecs::registry.emplace<ecs::Material>(m_entity);
+    ecs::registry.emplace<ecs::Renderable>(m_entity);
+  }
+
   void Object::setColor(glm::vec3 color) {
-    m_objectKd = color;
-    m_objectKa = color;
+    material().kd = color;
+    material().ka = color;
   }
-  void Object::setKa(glm::vec3 ka) { m_objectKa = ka; }
-  void Object::setKd(glm::vec3 kd) { m_objectKd = kd; }
-  void Object::setKs(glm::vec3 ks) { m_objectKs = ks; }
-  void Object::setShininess(float shininess) { m_objectShininess = shininess; }
-
-  glm::vec3 Object::getColor() { return m_objectKd; }
-  glm::vec3 Object::getKa() { return m_objectKa; }
-  glm::vec3 Object::getKd() { return m_objectKd; }
-  glm::vec3 Object::getKs() { return m_objectKs; }
-  float Object::getShininess() { return m_objectShininess; }
-
-  glm::vec3 Object::getAppliedRotation() { return m_appliedRotation; }
-  glm::vec3 Object::getAppliedScale() { return m_appliedScale; }
-  glm::vec3 Object::getAppliedTransformation() { return m_appliedTransformation; }
-  void Object::setAppliedRotation(glm::vec3 rotation) { m_appliedRotation = rotation; }
-  void Object::setAppliedScale(glm::vec3 scale) { m_appliedScale = scale; }
+  void Object::setKa(glm::vec3 ka) { material().ka = ka; }
+  void Object::setKd(glm::vec3 kd) { material().kd = kd; }
+  void Object::setKs(glm::vec3 ks) { material().ks = ks; }
+  void Object::setShininess(float shininess) { material().shininess = shininess; }
+
+  glm::vec3 Object::getColor() { return material().kd; }
+  glm::vec3 Object::getKa() { return material().ka; }
+  glm::vec3 Object::getKd() { return material().kd; }
+  glm::vec3 Object::getKs() { return material().ks; }
+  float Object::getShininess() { return material().shininess; }
+
+  glm::vec3 Object::getAppliedRotation() { return transform().getRotation(); }
+  glm::vec3 Object::getAppliedScale() { return transform().getScale(); }
+  glm::vec3 Object::getAppliedTransformation() { return transform().getPosition(); }
+  void Object::setAppliedRotation(glm::vec3 rotation) { transform().setRotation(rotation); }
+  void Object::setAppliedScale(glm::vec3 scale) { transform().setScale(scale); }
   void Object::setAppliedTransformation(glm::vec3 transformation) {
-    m_appliedTransformation = transformation;
+    transform().setPosition(transformation);
+  }
+
+  glm::vec3 Object::getPosition() { return transform().getPosition(); }
+  void Object::setPosition(glm::vec3 position) { transform().setPosition(position); }
+
+  Object::Shading Object::getShading() { return material().shading; }
+  void Object::setShading(Shading shading) { material().shading = shading; }
+
+  glm::mat4 Object::getModelMatrix() {
+    return glm::scale(transform().getWorldMatrix(), renderable().meshScale);
+  }
+
+  glm::vec3 Object::getMeshScale() { return renderable().meshScale; }
+
+  bloom::Mesh* Object::getMesh() { return renderable().getLevel().mesh; }
+
+  uint32_t Object::getLod() { return renderable().getLevel().lod; }
+
+  void Object::draw() { getMesh()->draw(getLod()); }
+
+  InstanceData Object::getInstanceData() {
+    return getInstanceData(transform(), material(), renderable());
   }
 
-  Object::Shading Object::getShading() { return m_shading; }
-  void Object::setShading(Shading shading) { m_shading = shading; }
+  InstanceData Object::getInstanceData(const ecs::Transform& transform,
+                                       const ecs::Material& material,
+                                       const ecs::Renderable& renderable) {
+    // The mesh scale divides the normal matrix, its inverse transpose
+    const glm::mat3 normal = transform.getNormalMatrix();
+    const glm::vec3 meshScale = ecs::nonZeroScale(renderable.meshScale);
+
+    return {glm::scale(transform.getWorldMatrix(), renderable.meshScale),
+            glm::vec4(material.ka, 1.0f),
+            glm::vec4(material.kd, 1.0f),
+            glm::vec4(material.ks, material.shininess),
+            glm::mat3x4(glm::vec4(normal[0] / meshScale.x, 0.0f),
+                        glm::vec4(normal[1] / meshScale.y, 0.0f),
+                        glm::vec4(normal[2] / meshScale.z, 0.0f))};
+  }
 
 }  // namespace bloom
@@ -1,46 +1,127 @@
 #include <bloomCG/buffers/vertex_buffer_layout.hpp>
 #include <bloomCG/core/common.hpp>
 #include <bloomCG/core/core.hpp>
+#include <bloomCG/io/mesh_cache.hpp>
+#include <bloomCG/models/mesh_optimizer.hpp>
 #include <bloomCG/models/sphere.hpp>
 
 namespace bloom {
   Sphere::Sphere(glm::vec3 center, glm::vec3 color, float radius, uint16_t sectorCount,
                  uint16_t stackCount)
-      : m_center(center), m_radius(radius) {
-    m_objectKs = glm::vec3{.5, .5, .5};
-    m_objectShininess = 32;
-    m_objectKa = color;
-    m_objectKd = color;
-    m_appliedTransformation = center;
+      : m_radius(radius), m_sectorCount(0), m_stackCount(0) {
+    setColor(color);
+    setAppliedTransformation(center);
+    renderable().autoLod = true;
     set(m_radius, sectorCount, stackCount);
   }
 
   void Sphere::set(float radius, uint16_t sectorCount, uint16_t stackCount) {
+    if (sectorCount < MIN_SECTOR_COUNT) sectorCount = MIN_SECTOR_COUNT;
+    if (stackCount < MIN_STACK_COUNT) stackCount = MIN_STACK_COUNT;
+
+    // The radius is only a scale, just the tessellation requires a different mesh
     m_radius = radius;
+    renderable().meshScale = glm::vec3(m_radius);
+
+    if (!m_meshes.empty() && sectorCount == m_sectorCount && stackCount == m_stackCount) return;
+
     m_sectorCount = sectorCount;
     m_stackCount = stackCount;
 
-    if (sectorCount < MIN_SECTOR_COUNT) m_sectorCount = MIN_SECTOR_COUNT;
-    if (sectorCount < MIN_STACK_COUNT) m_sectorCount = MIN_STACK_COUNT;
+    acquireMesh();
+  }
+
+  void Sphere::acquireMesh() {
+    std::vector<std::pair<MeshKey, std::function<MeshData()>>> levels;
+
+    if (m_type == Type::ICOSPHERE) {
+      levels.push_back({{MeshType::ICOSPHERE, {}}, generateIcosphereMesh});
+    } else {
+      for (int level = 0; level < UV_LEVELS; level++) {
+        const int shift = UV_LEVELS - 1 - level;
+        const uint16_t sectorCount = std::max(MIN_SECTOR_COUNT, m_sectorCount >> shift);
+        const uint16_t stackCount = std::max(MIN_STACK_COUNT, m_stackCount >> shift);
+
+        levels.push_back({{MeshType::SPHERE, {sectorCount, stackCount}},
+                          [=]() { return generateMesh(sectorCount, stackCount); }});
+      }
+    }
+
+    m_pending.clear();
+    for (const auto& level : levels) {
+      const MeshKey& key = level.first;
+      const auto& generate = level.second;
+
+      if (!m_meshes.empty()) {
+        m_pending.push_back(MeshRegistry::request(key, generate));
+        continue;
+      }
+
+      // A new sphere has nothing to draw meanwhile, it is built right away
+      auto request = std::make_shared<MeshRequest>();
+      request->key = key;
+      request->mesh = MeshRegistry::acquire(
+          key, [&generate]() { return std::make_shared<bloom::Mesh>(generate()); });
+      m_pending.push_back(request);
+    }
+
+    // Levels that already exist are ready at once, the others are checked every frame
+    if (!swapMeshes() && !ecs::registry.has<ecs::PendingUpdate>(m_entity))
+      ecs::registry.emplace<ecs::PendingUpdate>(m_entity, [this]() { return swapMeshes(); });
+  }
+
+  bool Sphere::swapMeshes() {
+    if (m_pending.empty()) return true;
+    for (const auto& request : m_pending)
+      if (!request->isReady()) return false;
+
+    m_meshes.clear();
+    for (const auto& request : m_pending) m_meshes.push_back(request->mesh);
+    m_pending.clear();
+    m_meshType = m_type;
+
+    ecs::Renderable& data = renderable();
+    data.levelCount = getLodCount();
+    for (uint8_t level = 0; level < data.levelCount; level++) {
+      data.levels[level] = m_meshType == Type::ICOSPHERE
+                               ? ecs::Renderable::Level{m_meshes[0].get(), level}
+                               : ecs::Renderable::Level{m_meshes[level].get(), 0};
+    }
+
+    // Full detail until the automatic selection (if any) says otherwise
+    data.level = data.levelCount - 1;
+
+    return true;
+  }
+
+  void Sphere::setType(Type type) {
+    if (type == m_type) return;
+
+    m_type = type;
+    acquireMesh();
+  }
 
-    buildVertices();
-    bindBuffers();
+  uint32_t Sphere::getLodCount() const {
+    return m_meshType == Type::ICOSPHERE ? ICOSPHERE_LEVELS : UV_LEVELS;
   }
 
-  void Sphere::bindBuffers() {
-    m_vertexBuffer = std::make_unique<bloom::VertexBuffer>(m_vertexData.data(),
-                                                           m_vertexData.size() * sizeof(float));
+  uint8_t Sphere::getLodLevel() { return renderable().level; }
 
-    m_layoutBuffer = new bloom::VertexBufferLayout();
-    m_layoutBuffer
-        ->push<float>(3)  // Three floats (coordinates)        x, y, z
-        .push<float>(3)   // Three floats (normals)            nx, ny, nz
-        .push<float>(3);  // Three floats (averagedNormal)            nx, ny, nz
+  void Sphere::setLod(uint8_t lod) {
+    renderable().level = std::min<uint32_t>(lod, getLodCount() - 1);
+  }
 
-    m_indexBuffer = new bloom::IndexBuffer(m_indices.data(), m_indices.size());
+  bool Sphere::isAutoLod() { return renderable().autoLod; }
 
-    m_vertexArray = std::make_unique<bloom::VertexArray>();
-    m_vertexArray->addBuffer(*m_vertexBuffer, *m_layoutBuffer);
+  void Sphere::setAutoLod(bool enabled) {
+    renderable().autoLod = enabled;
+    if (!enabled) renderable().level = getLodCount() - 1;
+  }
+
+  uint32_t Sphere::getTrianglesSaved() {
+    // The finest level is the last UV mesh, or the last range of the icosphere mesh
+    const ecs::Renderable::Level& finest = renderable().levels[renderable().levelCount - 1];
+    return finest.mesh->getTriangleCount(finest.lod) - getMesh()->getTriangleCount(getLod());
   }
 
   void Sphere::setRadius(float radius) {
@@ -60,226 +141,209 @@ namespace bloom {
     fmt::print("Radius: {:>15}\n", m_radius);
     fmt::print("Sector Count: {:>15}\n", m_sectorCount);
     fmt::print("Stack count: {:>15}\n", m_stackCount);
-    fmt::print("Triangle count: {:>15}\n", getTriangleCount());
-    fmt::print("Index count: {:>15}\n", getIndexCount());
-    fmt::print("Vertices count: {:>15}\n", getVertexCount());
-    fmt::print("Positions count: {:>15}\n", getPositionCount());
-    fmt::print("Normals count: {:>15}\n", getNormalCount());
+    fmt::print("Triangle count: {:>15}\n", getMesh()->getTriangleCount(getLod()));
+    fmt::print("Index count: {:>15}\n", getMesh()->getIndexCount());
+    fmt::print("Vertices count: {:>15}\n", getMesh()->getVertexCount());
+    fmt::print("ACMR: {:>15.3f} (was {:.3f})\n", getMesh()->getCacheStats().acmrAfter,
+               getMesh()->getCacheStats().acmrBefore);
+    fmt::print("Mesh users: {:>15}\n", m_meshes.back().use_count());
   }
 
-  void Sphere::clearVertex() {
-    std::vector<float>().swap(m_positions);
-    std::vector<float>().swap(m_normals);
-    std::vector<float>().swap(m_averageNormals);
-    std::vector<uint32_t>().swap(m_indices);
-  }
+  Sphere::Vertex Sphere::packVertex(const glm::vec3& position, const glm::vec3& faceNormal) {
+    // On the unit sphere the position is also the vertex normal
+    Vertex vertex;
+    vertex.position = {pack::snorm16(position.x), pack::snorm16(position.y),
+                       pack::snorm16(position.z), pack::snorm16(1.f)};
+    vertex.normal = pack::snorm1010102(position);
+    vertex.faceNormal = pack::snorm1010102(faceNormal);
 
-  void Sphere::buildVertices() {
-    // Clear old data
-    clearVertex();
-
-    float sectorStep = 2 * M_PI / m_sectorCount;
-    float stackStep = M_PI / m_stackCount;
-    float lengthInverse = 1.0f / m_radius;
-
-    struct Vertex {
-      float x, y, z;
-      float nx, ny, nz;
-    };
-    std::vector<Vertex> tmpVertices;
-
-    // Calculate the vertices
-    for (uint16_t i = 0; i <= m_stackCount; i++) {
-      float stackAngle = M_PI / 2 - i * stackStep;
-      float xy = m_radius * cos(stackAngle);
-      float zx = m_radius * sin(stackAngle);
+    return vertex;
+  }
 
-      for (uint16_t j = 0; j <= m_sectorCount; j++) {
-        float sectorAngle = j * sectorStep;
+  bloom::VertexBufferLayout Sphere::vertexLayout() {
+    bloom::VertexBufferLayout layout;
+    layout
+        .push<int16_t>(4, true)         // Position          x, y, z, w
+        .push<Packed1010102>(4, true)   // Normal            nx, ny, nz
+        .push<Packed1010102>(4, true);  // Face normal       nx, ny, nz
 
-        float x = xy * cos(sectorAngle);
-        float y = xy * sin(sectorAngle);
-        float z = zx;
+    return layout;
+  }
 
-        tmpVertices.push_back({x, y, z, x * lengthInverse, y * lengthInverse, z * lengthInverse});
-      }
+  MeshData Sphere::generateMesh(uint16_t sectorCount, uint16_t stackCount) {
+    // The first and last stacks are triangles around the poles, the others quads. Flat shading
+    // reads a per face normal, so vertices are shared inside a quad but not across faces.
+    const uint32_t sectors = sectorCount, stacks = stackCount;
+    const uint32_t poleFaces = 2 * sectors;
+    const uint32_t quadFaces = (stacks - 2) * sectors;
+    const uint32_t vertexCount = 3 * poleFaces + 4 * quadFaces;
+    const uint32_t indexCount = 3 * poleFaces + 6 * quadFaces;
+
+    // Dense tessellations are read back from the mesh cache instead of being generated again
+    const std::string cacheName = fmt::format("sphere-{}x{}", sectors, stacks);
+    const uint64_t sourceHash = io::hashValues(MESH_VERSION, sectors, stacks);
+    MeshData data;
+    if (io::MeshCache::load(cacheName, sourceHash, data)) return data;
+
+    std::vector<Vertex> vertexData(vertexCount);
+    std::vector<uint32_t> indices(indexCount);
+
+    // A grid point is the product of a sector and a stack term, so the trigonometry is done once
+    // per column and row instead of once per vertex. Entries are (cos, sin).
+    std::vector<glm::vec2> angles(sectors + 1 + stacks + 1);
+    glm::vec2* sector = angles.data();
+    glm::vec2* stack = sector + sectors + 1;
+
+    const float sectorStep = 2 * M_PI / sectors;
+    const float stackStep = M_PI / stacks;
+
+    for (uint32_t j = 0; j < sectors; j++)
+      sector[j] = {std::cos(j * sectorStep), std::sin(j * sectorStep)};
+    sector[sectors] = sector[0];  // Closes the seam exactly
+
+    for (uint32_t i = 1; i < stacks; i++) {
+      const float stackAngle = M_PI / 2 - i * stackStep;
+      stack[i] = {std::cos(stackAngle), std::sin(stackAngle)};
     }
+    stack[0] = {0.f, 1.f};
+    stack[stacks] = {0.f, -1.f};
 
-    clearVertex();
+    // Point of the unit sphere, which is also its normal
+    auto point = [&](uint32_t i, uint32_t j) {
+      return glm::vec3{stack[i].x * sector[j].x, stack[i].x * sector[j].y, stack[i].y};
+    };
 
-    uint32_t index = 0;
-    for (uint16_t i = 0; i < m_stackCount; ++i) {
-      uint32_t k1 = i * (m_sectorCount + 1);
-      uint32_t k2 = k1 + m_sectorCount + 1;
+    auto faceNormal = [](const glm::vec3& a, const glm::vec3& b, const glm::vec3& c) {
+      const glm::vec3 normal = glm::cross(b - a, c - a);
+      const float length = glm::length(normal);
+      return length > 1e-6f ? normal / length : glm::vec3{0.f};
+    };
 
-      for (uint16_t j = 0; j < m_sectorCount; ++j, ++k1, ++k2) {
-        Vertex v1 = tmpVertices[k1];
-        Vertex v2 = tmpVertices[k2];
-        Vertex v3 = tmpVertices[k1 + 1];
-        Vertex v4 = tmpVertices[k2 + 1];
+    Vertex* vertex = vertexData.data();
+    auto emit = [&vertex](const glm::vec3& position, const glm::vec3& normal) {
+      *vertex++ = packVertex(position, normal);
+    };
 
-        if (i == 0) {
-          addPosition(v1.x, v1.y, v1.z);
-          addPosition(v2.x, v2.y, v2.z);
-          addPosition(v4.x, v4.y, v4.z);
+    uint32_t* index = indices.data();
+    uint32_t base = 0;
 
-          addNormal(v1.nx, v1.ny, v1.nz);
-          addNormal(v2.nx, v2.ny, v2.nz);
-          addNormal(v4.nx, v4.ny, v4.nz);
+    for (uint32_t i = 0; i < stacks; i++) {
+      for (uint32_t j = 0; j < sectors; j++) {
+        const glm::vec3 v1 = point(i, j), v2 = point(i + 1, j);
+        const glm::vec3 v3 = point(i, j + 1), v4 = point(i + 1, j + 1);
 
-          auto averagedNormal
-              = computeFaceNormal(v1.x, v1.y, v1.z, v2.x, v2.y, v2.z, v4.x, v4.y, v4.z);
-          addAveragedNormal(averagedNormal[0], averagedNormal[1], averagedNormal[2]);
-          addAveragedNormal(averagedNormal[0], averagedNormal[1], averagedNormal[2]);
-          addAveragedNormal(averagedNormal[0], averagedNormal[1], averagedNormal[2]);
+        if (i == 0 || i == stacks - 1) {
+          // v1 and v3 meet at the north pole, v2 and v4 at the south one
+          const glm::vec3& third = i == 0 ? v4 : v3;
+          const glm::vec3 normal = faceNormal(v1, v2, third);
+          emit(v1, normal);
+          emit(v2, normal);
+          emit(third, normal);
 
-          addIndices(index, index + 1, index + 2);
-          index += 3;
-        } else if (i == (m_stackCount - 1)) {
-          addPosition(v1.x, v1.y, v1.z);
-          addPosition(v2.x, v2.y, v2.z);
-          addPosition(v3.x, v3.y, v3.z);
-
-          addNormal(v1.nx, v1.ny, v1.nz);
-          addNormal(v2.nx, v2.ny, v2.nz);
-          addNormal(v3.nx, v3.ny, v3.nz);
-
-          auto averagedNormal
-              = computeFaceNormal(v1.x, v1.y, v1.z, v2.x, v2.y, v2.z, v3.x, v3.y, v3.z);
-          addAveragedNormal(averagedNormal[0], averagedNormal[1], averagedNormal[2]);
-          addAveragedNormal(averagedNormal[0], averagedNormal[1], averagedNormal[2]);
-          addAveragedNormal(averagedNormal[0], averagedNormal[1], averagedNormal[2]);
-
-          addIndices(index, index + 1, index + 2);
+          index[0] = base, index[1] = base + 1, index[2] = base + 2;
           index += 3;
+          base += 3;
         } else {
-          addPosition(v1.x, v1.y, v1.z);
-          addPosition(v2.x, v2.y, v2.z);
-          addPosition(v3.x, v3.y, v3.z);
-          addPosition(v4.x, v4.y, v4.z);
-
-          addNormal(v1.x, v1.y, v1.z);
-          addNormal(v2.x, v2.y, v2.z);
-          addNormal(v3.x, v3.y, v3.z);
-          addNormal(v4.x, v4.y, v4.z);
-
-          auto averagedNormal
-              = computeFaceNormal(v1.x, v1.y, v1.z, v2.x, v2.y, v2.z, v3.x, v3.y, v3.z);
-          addAveragedNormal(averagedNormal[0], averagedNormal[1], averagedNormal[2]);
-          addAveragedNormal(averagedNormal[0], averagedNormal[1], averagedNormal[2]);
-          addAveragedNormal(averagedNormal[0], averagedNormal[1], averagedNormal[2]);
-          addAveragedNormal(averagedNormal[0], averagedNormal[1], averagedNormal[2]);
-
-          addIndices(index, index + 1, index + 2);
-          addIndices(index + 2, index + 1, index + 3);
-
-          index += 4;
+          const glm::vec3 normal = faceNormal(v1, v2, v3);
+          emit(v1, normal);
+          emit(v2, normal);
+          emit(v3, normal);
+          emit(v4, normal);
+
+          index[0] = base, index[1] = base + 1, index[2] = base + 2;
+          index[3] = base + 2, index[4] = base + 1, index[5] = base + 3;
+          index += 6;
+          base += 4;
         }
       }
     }
 
-    buildVertexData();
+    // Vertices are only shared inside a quad, reordering mostly helps fetching here
+    const MeshCacheStats stats = meshopt::optimize(vertexData, indices);
+
+    data = MeshData::from(std::move(vertexData), vertexLayout(), std::move(indices), {}, stats);
+    io::MeshCache::store(cacheName, sourceHash, data);
+
+    return data;
   }
 
-  void Sphere::buildVertexData() {
-    std::vector<float>().swap(m_vertexData);
+  MeshData Sphere::generateIcosphereMesh() {
+    const std::string cacheName = fmt::format("icosphere-{}", ICOSPHERE_LEVELS);
+    const uint64_t sourceHash = io::hashValues(MESH_VERSION, ICOSPHERE_LEVELS);
 
-    for (std::size_t i = 0; i < m_positions.size(); i += 3) {
-      m_vertexData.push_back(m_positions[i]);
-      m_vertexData.push_back(m_positions[i + 1]);
-      m_vertexData.push_back(m_positions[i + 2]);
+    MeshData data;
+    if (io::MeshCache::load(cacheName, sourceHash, data)) return data;
 
-      m_vertexData.push_back(m_normals[i]);
-      m_vertexData.push_back(m_normals[i + 1]);
-      m_vertexData.push_back(m_normals[i + 2]);
+    // Level n + 1 splits every triangle of level n in four. Midpoints are appended to the same
+    // vertex pool, so each level only adds vertices and its indices follow the previous level's.
+    const float t = (1.f + std::sqrt(5.f)) / 2.f;
 
-      m_vertexData.push_back(m_averageNormals[i]);
-      m_vertexData.push_back(m_averageNormals[i + 1]);
-      m_vertexData.push_back(m_averageNormals[i + 2]);
+    uint32_t vertexCount = 12;
+    uint32_t indexCount = 0;
+    for (uint32_t level = 0; level < ICOSPHERE_LEVELS; level++) {
+      const uint32_t faces = 20u << (2 * level);
+      indexCount += 3 * faces;
+      if (level > 0) vertexCount += faces / 4 * 3 / 2;  // One midpoint per edge of the level above
     }
-  }
 
-  void Sphere::addPosition(float x, float y, float z) {
-    m_positions.emplace_back(x);
-    m_positions.emplace_back(y);
-    m_positions.emplace_back(z);
-  }
+    std::vector<glm::vec3> positions;
+    positions.reserve(vertexCount);
+    for (glm::vec3 corner : {glm::vec3{-1, t, 0}, glm::vec3{1, t, 0}, glm::vec3{-1, -t, 0},
+                             glm::vec3{1, -t, 0}, glm::vec3{0, -1, t}, glm::vec3{0, 1, t},
+                             glm::vec3{0, -1, -t}, glm::vec3{0, 1, -t}, glm::vec3{t, 0, -1},
+                             glm::vec3{t, 0, 1}, glm::vec3{-t, 0, -1}, glm::vec3{-t, 0, 1}})
+      positions.push_back(glm::normalize(corner));
+
+    // Counter-clockwise seen from outside
+    std::vector<uint32_t> indices = {
+        0, 11, 5, 0, 5, 1, 0, 1, 7, 0, 7, 10, 0, 10, 11,  // Around vertex 0
+        1, 5, 9, 5, 11, 4, 11, 10, 2, 10, 7, 6, 7, 1, 8,  // Adjacent band
+        3, 9, 4, 3, 4, 2, 3, 2, 6, 3, 6, 8, 3, 8, 9,      // Around vertex 3
+        4, 9, 5, 2, 4, 11, 6, 2, 10, 8, 6, 7, 9, 8, 1,    // Adjacent band
+    };
+    indices.reserve(indexCount);
 
-  void Sphere::addNormal(float nx, float ny, float nz) {
-    m_normals.emplace_back(nx);
-    m_normals.emplace_back(ny);
-    m_normals.emplace_back(nz);
-  }
+    std::vector<MeshLod> lods;
+    std::unordered_map<uint64_t, uint32_t> midpoints;
 
-  void Sphere::addAveragedNormal(float nx, float ny, float nz) {
-    m_averageNormals.emplace_back(nx);
-    m_averageNormals.emplace_back(ny);
-    m_averageNormals.emplace_back(nz);
-  }
+    auto midpoint = [&](uint32_t a, uint32_t b) {
+      const uint64_t edge = (uint64_t)std::min(a, b) << 32 | std::max(a, b);
+      auto [it, inserted] = midpoints.try_emplace(edge, (uint32_t)positions.size());
+      if (inserted) positions.push_back(glm::normalize(positions[a] + positions[b]));
+      return it->second;
+    };
 
-  void Sphere::addIndices(uint32_t a, uint32_t b, uint32_t c) {
-    m_indices.emplace_back(a);
-    m_indices.emplace_back(b);
-    m_indices.emplace_back(c);
-  }
+    for (uint32_t level = 0; level < ICOSPHERE_LEVELS; level++) {
+      const uint32_t first = lods.empty() ? 0 : lods.back().firstIndex + lods.back().indexCount;
+      lods.push_back({first, (uint32_t)indices.size() - first});
+      if (level + 1 == ICOSPHERE_LEVELS) break;
 
-  glm::vec3 Sphere::getPosition() { return m_appliedTransformation; }
+      midpoints.clear();
+      midpoints.reserve(lods.back().indexCount / 2);
 
-  void Sphere::setPosition(glm::vec3 position) {
-    m_appliedTransformation = position;
-    buildVertices();
-  }
+      for (uint32_t i = first; i < first + lods.back().indexCount; i += 3) {
+        const uint32_t a = indices[i], b = indices[i + 1], c = indices[i + 2];
+        const uint32_t ab = midpoint(a, b), bc = midpoint(b, c), ca = midpoint(c, a);
 
-  void Sphere::shiftVertex() {
-    for (std::size_t i = 0; i < m_positions.size(); i += 3) {
-      m_positions[i] += m_center.x;
-      m_positions[i + 1] += m_center.y;
-      m_positions[i + 2] += m_center.z;
+        for (uint32_t index : {a, ab, ca, b, bc, ab, c, ca, bc, ab, bc, ca})
+          indices.push_back(index);
+      }
     }
-  }
-
-  void Sphere::draw() {
-    m_vertexArray->bind();
-    m_vertexBuffer->bind();
-    m_indexBuffer->bind();
 
-    GLCall(glDrawElements(GL_TRIANGLES, m_indexBuffer->getCount(), GL_UNSIGNED_INT, nullptr));
+    // Same layout as the UV sphere. Neighbouring faces share vertices, so the last attribute
+    // holds the vertex normal; flat shading takes one vertex per face instead.
+    std::vector<Vertex> vertexData;
+    vertexData.reserve(positions.size());
+    for (const glm::vec3& position : positions)
+      vertexData.push_back(packVertex(position, position));
 
-    m_indexBuffer->unbind();
-    m_vertexBuffer->unbind();
-    m_vertexArray->unbind();
-  }
+    // Subdivision order revisits vertices long after they left the cache
+    const MeshCacheStats stats = meshopt::optimize(vertexData, indices, lods, &positions);
 
-  std::vector<float> Sphere::computeFaceNormal(float x1, float y1, float z1, float x2, float y2,
-                                               float z2, float x3, float y3, float z3) {
-    const float EPSILON = 0.000001f;
-
-    std::vector<float> normal(3, 0.0f);  // default return value (0,0,0)
-    float nx, ny, nz;
-
-    // find 2 edge vectors: v1-v2, v1-v3
-    float ex1 = x2 - x1;
-    float ey1 = y2 - y1;
-    float ez1 = z2 - z1;
-    float ex2 = x3 - x1;
-    float ey2 = y3 - y1;
-    float ez2 = z3 - z1;
-
-    // cross product: e1 x e2
-    nx = ey1 * ez2 - ez1 * ey2;
-    ny = ez1 * ex2 - ex1 * ez2;
-    nz = ex1 * ey2 - ey1 * ex2;
-
-    // normalize only if the length is > 0
-    float length = sqrtf(nx * nx + ny * ny + nz * nz);
-    if (length > EPSILON) {
-      // normalize
-      float lengthInv = 1.0f / length;
-      normal[0] = nx * lengthInv;
-      normal[1] = ny * lengthInv;
-      normal[2] = nz * lengthInv;
-    }
+    data = MeshData::from(std::move(vertexData), vertexLayout(), std::move(indices), lods, stats);
+    io::MeshCache::store(cacheName, sourceHash, data);
 
-    return normal;
+    return data;
   }
+
 }  // namespace bloom
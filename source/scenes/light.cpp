@@ -1,10 +1,14 @@
 #include <bloomCG/core/camera.hpp>
 #include <bloomCG/core/core.hpp>
+#include <bloomCG/core/job_system.hpp>
+#include <bloomCG/core/lod.hpp>
+#include <bloomCG/core/profiler.hpp>
 #include <bloomCG/core/renderer.hpp>
 #include <bloomCG/models/light.hpp>
 #include <bloomCG/scenes/light.hpp>
 #include <bloomCG/structures/hierarchy.hpp>
 #include <bloomCG/structures/shader.hpp>
+#include <bloomCG/structures/transform_system.hpp>
 #include <bloomCG/utils/imgui.hpp>
 #include <bloomCG/utils/polymorphism.hpp>
 
@@ -12,11 +16,13 @@
 
 namespace bloom {
   namespace scene {
-    int8_t selected = -1;
+    int32_t selected = -1;  // Position in hierarchyEntities
 
     bool m_wireframe = false;
     bool m_depthBuffer = true;
     bool m_orbitLights = true;
+    bool m_instancedRendering = false;
+    bool m_clusteredShading = false;
 
     // clang-format off
     // +++++++++++++++++++ MODAL +++++++++++++++++++++++++
@@ -43,6 +49,16 @@ namespace bloom {
     /**/ glm::vec3 resultColorCube;                     /**/
     /**/ float resultSideCube;                          /**/
     /*                                                  */
+    /*                      MODEL                       */
+    /**/ bool m_modalModel = false;                     /**/
+    /**/ bool m_editingModel = false;                   /**/
+    /**/ char namePtrModel[64];                         /**/
+    /**/ char pathModel[256];                           /**/
+    /**/ std::string errorMessageModel = "";            /**/
+    /**/ glm::vec3 resultPositionModel;                 /**/
+    /**/ glm::vec3 resultColorModel;                    /**/
+    /**/ float resultSizeModel;                         /**/
+    /*                                                  */
     /*                      LIGHT                       */
     /**/ bool m_modalLight = false;                      /**/
     /**/ bool m_editingLight = false;                    /**/
@@ -69,8 +85,55 @@ namespace bloom {
     bool m_increaseWindow = false;
     bool m_decreaseWindow = false;
 
-    std::array<double, 8> randomVelocities;
-    std::array<double, 8> randomDistances;
+    // Orbit parameters, one entry per point light index, grown as lights are added
+    std::vector<float> randomVelocities;
+    std::vector<float> randomDistances;
+
+    // Pick the program matching the object shading model
+    template <ShaderType Type> bloom::Shader* getObjectShader(bloom::Object::Shading shading) {
+      switch ((LightModel)shading) {
+        case LightModel::Flat:
+          return shaders->get<Type, LightModel::Flat>();
+        case LightModel::Gouraud:
+          return shaders->get<Type, LightModel::Gouraud>();
+        case LightModel::Phong:
+        default:
+          return shaders->get<Type, LightModel::Phong>();
+      }
+    }
+
+    // Program for an object given the active rendering toggles
+    bloom::Shader* selectObjectShader(bloom::Object::Shading shading) {
+      if (m_instancedRendering)
+        return m_clusteredShading ? getObjectShader<ShaderType::InstancedClusteredObject>(shading)
+                                  : getObjectShader<ShaderType::InstancedObject>(shading);
+
+      return m_clusteredShading ? getObjectShader<ShaderType::ClusteredObject>(shading)
+                                : getObjectShader<ShaderType::Object>(shading);
+    }
+
+    // Pick the level of detail from the size on screen, returns the triangles saved
+    uint32_t updateLod(ecs::Renderable& renderable, const ecs::Transform& transform,
+                       const glm::mat4& projection) {
+      if (renderable.levelCount < 2) return 0;
+
+      if (renderable.autoLod) {
+        const glm::vec3 meshScale = glm::abs(renderable.meshScale);
+        const float radius = renderable.boundingRadius * transform.getMaxScale()
+                             * std::max({meshScale.x, meshScale.y, meshScale.z});
+        const float distance
+            = glm::length(transform.getWorldPosition() - cameraObject->getPosition());
+
+        renderable.level = bloom::lod::select(
+            bloom::lod::projectedRadius(projection, Renderer::getViewportHeight(), distance,
+                                        radius),
+            renderable.level, renderable.levelCount);
+      }
+
+      const ecs::Renderable::Level& finest = renderable.levels[renderable.levelCount - 1];
+      const ecs::Renderable::Level& level = renderable.getLevel();
+      return finest.mesh->getTriangleCount(finest.lod) - level.mesh->getTriangleCount(level.lod);
+    }
 
     Light::Light() : m_translation(0.0f, 0.0f, 0.0f) {
       GLCall(glad_glEnable(GL_BLEND));
@@ -79,10 +142,8 @@ namespace bloom {
       // ================ Setting up Camera ================
       glm::vec3 position = glm::vec3(0.5f, 3.0f, 17.0f);
 
-      hierarchyObjects.emplace_back(
-          Objects{ObjectType::CAMERA, "Camera", 0, {.camera = new bloom::Camera(position)}});
-
-      cameraObject = (bloom::Camera*)getObjectByTypeRef<ObjectType::CAMERA>(0).get();
+      cameraObject = new bloom::Camera(position);
+      addToHierarchy(ObjectType::CAMERA, "Camera", cameraObject);
 
       int width = 1920 / 2, height = 1080 / 2;
 
@@ -103,11 +164,10 @@ namespace bloom {
       // ======================================================
 
       // ================ Setting up Floor ================
-      hierarchyObjects.emplace_back(
-          Objects{ObjectType::CUBE, "Floor", 0, {.cube = new bloom::Cube(glm::vec3{0})}});
+      bloom::Cube* floor = new bloom::Cube(glm::vec3{0});
+      addToHierarchy(ObjectType::CUBE, "Floor", floor);
 
       // Manipulate the floor
-      bloom::Cube* floor = ((bloom::Cube*)getObjectByType<ObjectType::CUBE>(0).get());
       floor->setAppliedTransformation(glm::vec3{0, -8, 0});
       floor->setAppliedScale(glm::vec3{1000, 0.01, 1000});
       floor->setColor(glm::vec3{0.5f, 0.5f, 0.5f});
@@ -116,12 +176,9 @@ namespace bloom {
       // ======================================================
 
       // ================ Setting up Sphere ================
-      hierarchyObjects.emplace_back(
-          Objects{ObjectType::SPHERE,
-                  "Sphere",
-                  0,
-                  {.sphere = new bloom::Sphere(glm::vec3{0, 0, 0}, glm::vec3{1, 0, 0}, 2,
-                                               m_sectorCount, m_stackCount)}});
+      addToHierarchy(ObjectType::SPHERE, "Sphere",
+                     new bloom::Sphere(glm::vec3{0, 0, 0}, glm::vec3{1, 0, 0}, 2, m_sectorCount,
+                                       m_stackCount));
       // ======================================================
 
       // ================ Setting up Shaders ================
@@ -134,14 +191,66 @@ namespace bloom {
       shaders->registerShader<ShaderType::Object, LightModel::Flat>(at("object.flat.glsl"))
           ->registerShader<ShaderType::Object, LightModel::Gouraud>(at("object.gouraud.glsl"))
           ->registerShader<ShaderType::Object, LightModel::Phong>(at("object.phong.glsl"))
+          ->registerShader<ShaderType::InstancedObject, LightModel::Flat>(
+              at("object.flat.instanced.glsl"))
+          ->registerShader<ShaderType::InstancedObject, LightModel::Gouraud>(
+              at("object.gouraud.instanced.glsl"))
+          ->registerShader<ShaderType::InstancedObject, LightModel::Phong>(
+              at("object.phong.instanced.glsl"))
           ->registerShader<ShaderType::Light, LightModel::Phong>(at("light.glsl"));
+
+      // Same programs, walking only the lights of their cluster (see bloom::LightClusters)
+      const std::vector<std::string> clustered = {
+          "CLUSTERED",
+          fmt::format("CLUSTER_GRID_X {}", bloom::LightClusters::GRID_X),
+          fmt::format("CLUSTER_GRID_Y {}", bloom::LightClusters::GRID_Y),
+          fmt::format("CLUSTER_GRID_Z {}", bloom::LightClusters::GRID_Z),
+      };
+
+      shaders
+          ->registerShader<ShaderType::ClusteredObject, LightModel::Flat>(at("object.flat.glsl"),
+                                                                          clustered)
+          ->registerShader<ShaderType::ClusteredObject, LightModel::Gouraud>(
+              at("object.gouraud.glsl"), clustered)
+          ->registerShader<ShaderType::ClusteredObject, LightModel::Phong>(at("object.phong.glsl"),
+                                                                           clustered)
+          ->registerShader<ShaderType::InstancedClusteredObject, LightModel::Flat>(
+              at("object.flat.instanced.glsl"), clustered)
+          ->registerShader<ShaderType::InstancedClusteredObject, LightModel::Gouraud>(
+              at("object.gouraud.instanced.glsl"), clustered)
+          ->registerShader<ShaderType::InstancedClusteredObject, LightModel::Phong>(
+              at("object.phong.instanced.glsl"), clustered);
+      // ======================================================
+
+      // ================ Setting up Per-frame data ================
+      // Grows on its own when a frame needs more (e.g. thousands of instances)
+      m_streamBuffer = std::make_unique<bloom::StreamBuffer>(1 << 20);
+      // ======================================================
+
+      // ================ Setting up Point lights ================
+      m_pointLightBuffer
+          = std::make_unique<bloom::TextureBuffer>(16 * sizeof(bloom::PointLightData));
+      m_lightClusters = std::make_unique<bloom::LightClusters>();
+      // ======================================================
+
+      // ================ Setting up Instancing ================
+      m_instanceLayout
+          .push<float>(4)  // Model matrix, one vec4 per column
+          .push<float>(4)
+          .push<float>(4)
+          .push<float>(4)
+          .push<float>(4)   // Ka
+          .push<float>(4)   // Kd
+          .push<float>(4)   // Ks + shininess
+          .push<float>(4)   // Normal matrix, one padded vec4 per column
+          .push<float>(4)
+          .push<float>(4);
       // ======================================================
 
       // =================== Lights in the scene ================
       auto ambientLight = new bloom::AmbientLight(glm::vec3{0.2f, 0.2f, 0.2f});
 
-      hierarchyObjects.emplace_back(
-          Objects{ObjectType::AMBIENT_LIGHT, "Ambient Light", 0, {.ambientLight = ambientLight}});
+      addToHierarchy(ObjectType::AMBIENT_LIGHT, "Ambient Light", ambientLight);
 
       glm::vec3 lightPositions[] = {
           glm::vec3(0.0f, 0.0f, 0.0f),
@@ -151,11 +260,9 @@ namespace bloom {
 
       int lightCount = sizeof(lightPositions) / sizeof(lightPositions[0]);
       for (int i = 0; i < lightCount; i++) {
-        hierarchyObjects.emplace_back(
-            Objects{ObjectType::POINT_LIGHT,
-                    fmt::format("Point Light{}", i == 0 ? "" : fmt::format(" ({})", i)),
-                    i,
-                    {.pointLight = new bloom::PointLight(lightPositions[i])}});
+        addToHierarchy(ObjectType::POINT_LIGHT,
+                       fmt::format("Point Light{}", i == 0 ? "" : fmt::format(" ({})", i)),
+                       new bloom::PointLight(lightPositions[i]));
       }
       // ==========================================================
 
@@ -163,12 +270,12 @@ namespace bloom {
       cameraObject->setViewportV(glm::vec2{-1, 1});
       cameraObject->setWindowSizeX(glm::vec2{-1, 1});
       cameraObject->setWindowSizeY(glm::vec2{-1, 1});
+    }
 
-      // Generate 8 random values between
-      for (int i = 0; i < 8; i++) {
-        randomVelocities[i] = .5 + std::rand() / ((RAND_MAX + 1u) / 2.5);
-        randomDistances[i] = 3.0 + std::rand() / ((RAND_MAX + 1u) / 2.);
-      }
+    // The hierarchy owns the objects of the scene
+    Light::~Light() {
+      clearHierarchy();
+      selected = -1;
     }
 
     void Light::onUpdate(const float deltaTime) {
@@ -177,39 +284,62 @@ namespace bloom {
       cameraObject->update(deltaTime);
 
       if (m_orbitLights) {
-        // Get all point lights
-        for (auto& object : getObjectByType<ObjectType::POINT_LIGHT>()) {
-          auto pointLight = (bloom::PointLight*)object.get();
-          auto tick = glfwGetTime();
-          auto index = object.index;
-          auto randomVelocity = randomVelocities[index];
-          auto randomDistance = randomDistances[index];
-
-          // Get the position of the light
-          glm::vec3 position = pointLight->getAppliedTransformation();
-
-          if (index % 4 == 0) {
-            position.x = sin(randomVelocity * tick) * randomDistance;
-            position.y = cos(randomVelocity * tick) * randomDistance;
-            position.z = sin(randomVelocity * tick) * randomDistance;
-          } else if (index % 4 == 1) {
-            position.x = sin(randomVelocity * tick) * randomDistance;
-            position.y = cos(randomVelocity * tick) * randomDistance;
-            position.z = cos(randomVelocity * tick) * randomDistance;
-          } else if (index % 4 == 2) {
-            position.x = cos(randomVelocity * tick) * randomDistance;
-            position.y = sin(randomVelocity * tick) * randomDistance;
-            position.z = sin(randomVelocity * tick) * randomDistance;
-          } else {
-            position.x = cos(randomVelocity * tick) * randomDistance;
-            position.y = sin(randomVelocity * tick) * randomDistance;
-            position.z = cos(randomVelocity * tick) * randomDistance;
-          }
+        BLOOM_PROFILE_SCOPE("Animate lights");
+        animateLights(glfwGetTime());
+      }
 
-          // Set the new position of the light.
-          pointLight->setAppliedTransformation(position);
+      // World matrices of whatever moved since the last frame, lights included
+      {
+        BLOOM_PROFILE_SCOPE("Update transforms");
+        ecs::updateTransforms();
+      }
+    }
+
+    void Light::animateLights(const double time) {
+      auto& lights = ecs::registry.pool<ecs::PointLight>();
+      auto& transforms = ecs::registry.pool<ecs::Transform>();
+      auto& nodes = ecs::registry.pool<HierarchyNode>();
+
+      // Random orbits for the lights that don't have one yet, std::rand isn't thread safe
+      for (std::size_t i = 0; i < lights.size(); i++) {
+        const HierarchyNode* node = nodes.tryGet(lights.getEntity(i));
+        if (!node) continue;
+
+        while (randomVelocities.size() <= (std::size_t)node->index) {
+          randomVelocities.push_back(.5f + std::rand() / ((RAND_MAX + 1u) / 2.5f));
+          randomDistances.push_back(3.0f + std::rand() / ((RAND_MAX + 1u) / 2.f));
         }
       }
+
+      // Every light only writes its own transform, one sine and one cosine each
+      const auto animate = [&](std::size_t begin, std::size_t end) {
+        for (std::size_t i = begin; i < end; i++) {
+          const ecs::EntityID entity = lights.getEntity(i);
+          const HierarchyNode* node = nodes.tryGet(entity);
+          ecs::Transform* transform = transforms.tryGet(entity);
+          if (!node || !transform) continue;
+
+          const int32_t index = node->index;
+          const double angle = randomVelocities[index] * time;
+          const float distance = randomDistances[index];
+          const float sine = std::sin(angle) * distance, cosine = std::cos(angle) * distance;
+
+          switch (index % 4) {
+            case 0:
+              transform->setPosition({sine, cosine, sine});
+              break;
+            case 1:
+              transform->setPosition({sine, cosine, cosine});
+              break;
+            case 2:
+              transform->setPosition({cosine, sine, sine});
+              break;
+            default:
+              transform->setPosition({cosine, sine, cosine});
+          }
+        }
+      };
+      bloom::JobSystem::get().parallelFor(lights.size(), LIGHTS_PER_JOB, animate);
     }
 
     void Light::onRender(const float deltaTime) {
@@ -221,11 +351,19 @@ namespace bloom {
 
       if (m_isPaused) return;
 
-      auto lightShader = shaders->get<ShaderType::Light, LightModel::Phong>();
-      lightShader->bind()
-          ->setUniformMat4f("uView", cameraObject->getViewMatrix())
-          ->setUniformMat4f("uProjection", cameraObject->getProjectionMatrix());
-      lightShader->unbind();
+      m_streamBuffer->beginFrame();
+
+      // Every program reads the camera from the same uniform block, so it is written once here
+      const bloom::StreamAllocation camera
+          = m_streamBuffer->allocateUniform(sizeof(bloom::CameraUniformBlock));
+      *(bloom::CameraUniformBlock*)camera.data = cameraObject->getUniformBlock();
+      m_streamBuffer->flush();
+      bloom::bindUniformRange(bloom::UniformBinding::Camera, camera.buffer, camera.offset,
+                              camera.size);
+      {
+        BLOOM_PROFILE_SCOPE("Upload lights");
+        uploadPointLights();
+      }
 
       // Move the light in a orbit around the center
       // m_translation.x = sin(glfwGetTime() * 3) * 3.0f;
@@ -238,115 +376,145 @@ namespace bloom {
         GLCall(glad_glPolygonMode(GL_FRONT_AND_BACK, GL_FILL));
       }
 
-      // Loop through the hierarchyObjects and draw them
-      for (auto& object : hierarchyObjects) {
-        if (!object.visible) continue;
-
-        switch (object.type) {
-          case ObjectType::CUBE:
-          case ObjectType::SPHERE: {
-            auto _object = (bloom::Object*)object.get();
-            glm::vec3 position = _object->getPosition();
-
-            glm::mat4 model = glm::mat4(1.0f);
-
-            // Translation
-            auto appliedTranslation = _object->getAppliedTransformation();
-            model = glm::translate(model, appliedTranslation);
-
-            // Rotation
-            auto appliedRotation = _object->getAppliedRotation();
-            model
-                = glm::rotate(model, glm::radians(appliedRotation.x), glm::vec3(1.0f, 0.0f, 0.0f));
-            model
-                = glm::rotate(model, glm::radians(appliedRotation.y), glm::vec3(0.0f, 1.0f, 0.0f));
-            model
-                = glm::rotate(model, glm::radians(appliedRotation.z), glm::vec3(0.0f, 0.0f, 1.0f));
-
-            // Scale
-            auto appliedScale = _object->getAppliedScale();
-            model = glm::scale(model, appliedScale);
-
-            bloom::Shader* shader = nullptr;
-
-            switch ((LightModel)_object->getShading()) {
-              case LightModel::Phong:
-                shader = shaders->get<ShaderType::Object, LightModel::Phong>();
-                break;
-              case LightModel::Gouraud:
-                shader = shaders->get<ShaderType::Object, LightModel::Gouraud>();
-                break;
-              case LightModel::Flat:
-                shader = shaders->get<ShaderType::Object, LightModel::Flat>();
-                break;
-            }
-
-            auto ambientLight
-                = (bloom::AmbientLight*)getObjectByType<ObjectType::AMBIENT_LIGHT>(0).get();
-
-            shader->bind()
-                ->setUniformMat4f("uW2V", cameraObject->getViewportMatrix())
-                ->setUniformMat4f("uProjection", cameraObject->getProjectionMatrix())
-                ->setUniformMat4f("uView", cameraObject->getViewMatrix())
-                ->setUniformMat4f("uModel", model)
-                ->setUniform3f("uCameraPosition", cameraObject->getPosition())
-                ->setUniform3f("uMaterial.ambient", _object->getKa())
-                ->setUniform3f("uMaterial.diffuse", _object->getKd())
-                ->setUniform3f("uMaterial.specular", _object->getKs())
-                ->setUniform1f("uMaterial.shininess", _object->getShininess())
-                ->setUniform3f("uAmbientLight.intensity", ambientLight->getIntensity());
-
-            auto lights = getObjectByType<ObjectType::POINT_LIGHT>();
-            if (!lights.empty()) {
-              for (auto& light : lights) {
-                std::string prefix = fmt::format("uPointLights[{}].", light.index);
-                auto _light = (bloom::PointLight*)light.get();
-
-                if (!light.visible) {
-                  shader->setUniform3f(prefix + "intensity", glm::vec3{0});
-                  continue;
-                }
-
-                shader->setUniform3f(prefix + "position", _light->getAppliedTransformation())
-                    ->setUniform3f(prefix + "intensity", _light->getIntensity())
-                    ->setUniform1f(prefix + "constant", 1.0f)
-                    ->setUniform1f(prefix + "linear", .09f)
-                    ->setUniform1f(prefix + "quadratic", .032f);
-              }
-            }
-
-            // Set light's constraints
-            shader->setUniform1i("uUseLighting", !lights.empty() ? 1 : 0);
-            shader->setUniform1i("uPointLightCount", lights.size());
-
-            _object->draw();
-            shader->unbind();
-            break;
-          }
-          case ObjectType::POINT_LIGHT: {
-            auto light = (bloom::PointLight*)object.get();
-            glm::vec3 position = object.get()->getPosition();
-            glm::mat4 model = glm::mat4(1.0f);
-
-            // Translation
-            auto appliedTranslation = light->getAppliedTransformation();
-            model = glm::translate(model, appliedTranslation);
-
-            lightShader->bind()
-                ->setUniformMat4f("uView", cameraObject->getViewMatrix())
-                ->setUniformMat4f("uProjection", cameraObject->getProjectionMatrix())
-                ->setUniformMat4f("uW2V", cameraObject->getViewportMatrix())
-                ->setUniformMat4f("uModel", model)
-                ->setUniform4f("uColor", glm::vec4{1});
-            light->draw();
-            lightShader->unbind();
+      // Submit the visible objects, the queue orders them to bind each program and mesh once
+      const glm::mat4 view = cameraObject->getViewMatrix();
+      const glm::mat4 projection = cameraObject->getProjectionMatrix();
+      {
+        BLOOM_PROFILE_SCOPE("Draw objects");
+        m_renderQueue.clear();
+        m_lodTrianglesSaved = 0;
+        ecs::registry.each<ecs::Renderable, ecs::Transform, ecs::Material, ecs::Visibility>(
+            [&](ecs::EntityID entity, ecs::Renderable& renderable, ecs::Transform& transform,
+                ecs::Material& material, ecs::Visibility& visibility) {
+              // Point lights are drawn as gizmos, after the objects
+              if (!visibility.visible || ecs::registry.has<ecs::PointLight>(entity)) return;
+
+              m_lodTrianglesSaved += updateLod(renderable, transform, projection);
+
+              const ecs::Renderable::Level& level = renderable.getLevel();
+              bloom::DrawItem item{
+                  selectObjectShader(material.shading), level.mesh,
+                  bloom::Object::getInstanceData(transform, material, renderable)};
+              item.depth = -(view * item.instance.model[3]).z;
+              item.lod = level.lod;
+
+              m_renderQueue.submit(item);
+            });
+
+        {
+          BLOOM_PROFILE_SCOPE("Sort");
+          m_renderQueue.sort();
+        }
 
-            break;
-          }
-          case ObjectType::CAMERA:
-          case ObjectType::AMBIENT_LIGHT:
+        if (m_instancedRendering)
+          renderInstanced();
+        else
+          m_renderQueue.execute([this](bloom::Shader* shader) { setLightingUniforms(shader); });
+      }
+
+      ecs::registry.each<ecs::PointLight, ecs::Transform, ecs::Renderable, ecs::Visibility>(
+          [this](ecs::EntityID, ecs::PointLight&, ecs::Transform& transform,
+                 ecs::Renderable& renderable, ecs::Visibility& visibility) {
+            if (visibility.visible) drawLightGizmo(transform, renderable);
+          });
+
+      m_streamBuffer->endFrame();
+    }
+
+    void Light::renderInstanced() {
+      // Items sharing the program and the geometry are next to each other once sorted, so every
+      // run of them becomes a single instanced draw call.
+      std::size_t end = 0;
+      for (std::size_t begin = 0; begin < m_renderQueue.size(); begin = end) {
+        const bloom::DrawItem& first = m_renderQueue[begin];
+
+        for (end = begin + 1; end < m_renderQueue.size(); end++) {
+          const bloom::DrawItem& item = m_renderQueue[end];
+          if (item.shader != first.shader || item.mesh != first.mesh || item.lod != first.lod)
             break;
         }
+
+        // Written straight into the mapped ring, the vertex array then points at that block
+        const uint32_t count = end - begin;
+        const bloom::StreamAllocation instances
+            = m_streamBuffer->allocate(count * sizeof(bloom::InstanceData));
+        auto* instance = (bloom::InstanceData*)instances.data;
+        for (std::size_t i = begin; i < end; i++) *instance++ = m_renderQueue[i].instance;
+        m_streamBuffer->flush();
+
+        first.mesh->getVertexArray()->addInstanceBuffer(instances.buffer, instances.offset,
+                                                        m_instanceLayout, 3);
+
+        first.shader->bind();
+        setLightingUniforms(first.shader);
+
+        first.mesh->drawInstanced(count, first.lod);
+        first.shader->unbind();
+      }
+    }
+
+    void Light::drawLightGizmo(const ecs::Transform& transform, ecs::Renderable& renderable) {
+      glm::mat4 model = glm::mat4(1.0f);
+
+      // Translation
+      model = glm::translate(model, transform.getWorldPosition());
+
+      // The gizmo shares the unit sphere mesh, so its radius is applied here
+      model = glm::scale(model, renderable.meshScale);
+
+      m_lodTrianglesSaved
+          += updateLod(renderable, transform, cameraObject->getProjectionMatrix());
+
+      auto lightShader = shaders->get<ShaderType::Light, LightModel::Phong>();
+      lightShader->bind()
+          ->setUniformMat4f("uModel", model)
+          ->setUniform4f("uColor", glm::vec4{1});
+      renderable.getLevel().mesh->draw(renderable.getLevel().lod);
+      lightShader->unbind();
+    }
+
+    void Light::uploadPointLights() {
+      // Read by every program bind of the frame
+      const auto ambientLights = getObjectsByType(ObjectType::AMBIENT_LIGHT);
+      m_ambientIntensity
+          = ambientLights.empty()
+                ? glm::vec3(0.0f)
+                : ecs::registry.get<ecs::AmbientLight>(ambientLights.front()).intensity;
+
+      m_pointLights.clear();
+      m_hasPointLights = false;
+
+      ecs::registry.each<ecs::PointLight, ecs::Transform, ecs::Visibility>(
+          [this](ecs::EntityID, ecs::PointLight& light, ecs::Transform& transform,
+                 ecs::Visibility& visibility) {
+            // Hidden lights still switch lighting on, they just don't contribute
+            m_hasPointLights = true;
+            if (visibility.visible)
+              m_pointLights.push_back(bloom::PointLight::getLightData(transform, light));
+          });
+
+      if (!m_pointLights.empty())
+        m_pointLightBuffer->setData(m_pointLights.data(),
+                                    m_pointLights.size() * sizeof(bloom::PointLightData));
+      m_pointLightBuffer->bind(POINT_LIGHTS_TEXTURE_SLOT);
+
+      if (m_clusteredShading) {
+        m_lightClusters->update(*cameraObject, m_pointLights);
+        m_lightClusters->bind(CLUSTERS_TEXTURE_SLOT, CLUSTER_LIGHTS_TEXTURE_SLOT);
+      }
+    }
+
+    void Light::setLightingUniforms(bloom::Shader* shader) {
+      shader->setUniform3f("uAmbientLight.intensity", m_ambientIntensity)
+          ->setUniform1i("uPointLights", POINT_LIGHTS_TEXTURE_SLOT)
+          ->setUniform1i("uPointLightCount", m_pointLights.size())
+          ->setUniform1i("uUseLighting", m_hasPointLights ? 1 : 0);
+
+      if (m_clusteredShading) {
+        shader->setUniform1i("uClusters", CLUSTERS_TEXTURE_SLOT)
+            ->setUniform1i("uClusterLights", CLUSTER_LIGHTS_TEXTURE_SLOT)
+            ->setUniform2f("uClusterDepth", glm::vec2{m_lightClusters->getNearPlane(),
+                                                      m_lightClusters->getDepthScale()});
       }
     }
 
@@ -359,27 +527,30 @@ namespace bloom {
         return;
       }
 
-      Objects currentSelected = hierarchyObjects[selected];
+      const ecs::EntityID entity = hierarchyEntities[selected];
+      HierarchyNode& currentSelected = getNode(entity);
 
       TextCentered(currentSelected.name);
 
       // Disable visibility checkbox
       if (currentSelected.type != ObjectType::CAMERA
           && currentSelected.type != ObjectType::AMBIENT_LIGHT) {
-        bool visible = currentSelected.visible;
+        bool& currentVisible = ecs::registry.get<ecs::Visibility>(entity).visible;
+        bool visible = currentVisible;
 
         ImGui::Checkbox(
             fmt::format("{} Object visibility", (visible ? (ICON_FA_EYE) : (ICON_FA_EYE_SLASH)))
                 .c_str(),
             &visible);
 
-        if (visible != currentSelected.visible) hierarchyObjects[selected].visible = visible;
+        if (visible != currentVisible) currentVisible = visible;
       }
 
-      auto object = (bloom::Object*)currentSelected.get();
+      bloom::Entity* selectedObject = currentSelected.object.get();
+      auto object = (bloom::Object*)selectedObject;
       {  // Transform
 
-        if (instanceof <bloom::AmbientLight, bloom::Camera>(currentSelected.get())) goto common_end;
+        if (instanceof <bloom::AmbientLight, bloom::Camera>(selectedObject)) goto common_end;
 
         glm::vec3 position = object->getAppliedTransformation();
 
@@ -398,7 +569,7 @@ namespace bloom {
         glm::vec3 appliedRotation = object->getAppliedRotation();
         glm::vec3 appliedScale = object->getAppliedScale();
 
-        if (! instanceof <bloom::Object>(currentSelected.get())) goto common_end;
+        if (! instanceof <bloom::Object>(selectedObject)) goto common_end;
 
         ImGui::SliderFloat3("Rotation", glm::value_ptr(appliedRotation), 0, 360.0f);
         ImGui::SliderFloat3("Scale", glm::value_ptr(appliedScale), 0, 1000.0f);
@@ -410,7 +581,7 @@ namespace bloom {
           object->setAppliedScale(glm::vec3(appliedScale));
         }
 
-        if (instanceof <bloom::PointLight>(currentSelected.get())) goto common_end;
+        if (instanceof <bloom::PointLight>(selectedObject)) goto common_end;
 
         ImGui::Separator();
         ImGui::Spacing();
@@ -436,8 +607,8 @@ namespace bloom {
           object->setShininess(shininess);
         }
 
-        if (instanceof <bloom::AmbientLight>(currentSelected.get())) goto common_end;
-        if (instanceof <bloom::PointLight>(currentSelected.get())) goto common_end;
+        if (instanceof <bloom::AmbientLight>(selectedObject)) goto common_end;
+        if (instanceof <bloom::PointLight>(selectedObject)) goto common_end;
 
         ImGui::Separator();
         ImGui::Spacing();
@@ -485,18 +656,58 @@ namespace bloom {
           float radius = sphere->getRadius();
           int32_t sectors = sphere->getSectorCount();
           int32_t stacks = sphere->getStackCount();
+          int32_t lod = sphere->getLodLevel();
+          const int32_t lodCount = sphere->getLodCount();
+          bool autoLod = sphere->isAutoLod();
+          bool icosphere = sphere->getType() == bloom::Sphere::Type::ICOSPHERE;
 
-          // In the same line three inputs for: radius, sectors and stacks
           ImGui::SliderFloat("Radius", &radius, 0.0f, 100.0f);
-          ImGui::SliderInt("Sectors", &sectors, 3, 100);
-          ImGui::SliderInt("Stacks", &stacks, 2, 100);
+          if (ImGui::Checkbox("Icosphere", &icosphere))
+            sphere->setType(icosphere ? bloom::Sphere::Type::ICOSPHERE : bloom::Sphere::Type::UV);
 
-          if (radius != sphere->getRadius() || sectors != sphere->getSectorCount()
-              || stacks != sphere->getStackCount()) {
-            sphere->setRadius(radius);
-            sphere->setSectorCount(sectors);
-            sphere->setStackCount(stacks);
+          if (!icosphere) {
+            ImGui::SliderInt("Sectors", &sectors, 3, 100);
+            ImGui::SliderInt("Stacks", &stacks, 2, 100);
+          }
+
+          // Level of detail, picked from the size on screen unless set by hand
+          if (ImGui::Checkbox("Automatic LOD", &autoLod)) sphere->setAutoLod(autoLod);
+          if (autoLod) {
+            ImGui::Text("Level of detail: %d / %d", lod, lodCount - 1);
+          } else if (ImGui::SliderInt("Level of detail", &lod, 0, lodCount - 1)) {
+            sphere->setLod(lod);
           }
+          ImGui::Text("Triangles: %u (%u saved)",
+                      sphere->getMesh()->getTriangleCount(sphere->getLod()),
+                      sphere->getTrianglesSaved());
+          ImGui::Text("ACMR: %.3f (%.3f unoptimized)",
+                      sphere->getMesh()->getCacheStats().acmrAfter,
+                      sphere->getMesh()->getCacheStats().acmrBefore);
+          if (sphere->isRebuilding()) ImGui::TextDisabled("Building mesh...");
+
+          // New tessellations are generated in the background, one request per edit
+          if (radius != sphere->getRadius() || sectors != sphere->getSectorCount()
+              || stacks != sphere->getStackCount())
+            sphere->set(radius, sectors, stacks);
+          break;
+        }
+        case ObjectType::MODEL: {
+          auto model = (bloom::Model*)object;
+          const bloom::Mesh* mesh = model->getMesh();
+
+          ImGui::Separator();
+          ImGui::Spacing();
+          ImGui::Text("Object");
+
+          float size = model->getSize();
+          ImGui::SliderFloat("Size", &size, 0.0f, 100.0f);
+          if (size != model->getSize()) model->setSize(size);
+
+          ImGui::TextWrapped("File: %s", model->getPath().c_str());
+          ImGui::Text("Vertices: %u", mesh->getVertexCount());
+          ImGui::Text("Triangles: %u", mesh->getTriangleCount());
+          ImGui::Text("ACMR: %.3f (%.3f unoptimized)", mesh->getCacheStats().acmrAfter,
+                      mesh->getCacheStats().acmrBefore);
           break;
         }
         case ObjectType::AMBIENT_LIGHT: {
@@ -662,6 +873,11 @@ namespace bloom {
 
           if (ImGui::MenuItem("Cube")) m_modalCube = true;
 
+          ImGui::TextColored(ImVec4(0.6f, 0.9f, 0.4f, 1.0f), ICON_FA_SHAPES);
+          ImGui::SameLine();
+
+          if (ImGui::MenuItem("Model")) m_modalModel = true;
+
           ImGui::TextColored(ImVec4(1.0f, 1.0f, 0.0f, 1.0f), ICON_FA_LIGHTBULB);
           ImGui::SameLine();
 
@@ -674,6 +890,8 @@ namespace bloom {
           ImGui::Checkbox("Wireframe", &m_wireframe);
           ImGui::Checkbox("Depth buffer", &m_depthBuffer);
           ImGui::Checkbox("Orbit lights", &m_orbitLights);
+          ImGui::Checkbox("Instanced rendering", &m_instancedRendering);
+          ImGui::Checkbox("Clustered shading", &m_clusteredShading);
           ImGui::EndMenu();
         }
 
@@ -685,14 +903,18 @@ namespace bloom {
 
         if (ImGui::MenuItem(ICON_FA_PAINT_ROLLER
                             " Clear scene")) {  // Clear everything except for the camera
-          auto camera = getObjectByType<ObjectType::CAMERA>(0);
-          auto ambienteLight = getObjectByType<ObjectType::AMBIENT_LIGHT>(0);
-          auto pointLight = getObjectByType<ObjectType::POINT_LIGHT>(0);
-
-          std::vector<Objects>().swap(hierarchyObjects);
-          hierarchyObjects.emplace_back(camera);
-          hierarchyObjects.emplace_back(ambienteLight);
-          hierarchyObjects.emplace_back(pointLight);
+          // The first camera, ambient light and point light are kept
+          std::vector<ObjectType> kept;
+          removeFromHierarchyIf([&kept](const HierarchyNode& node) {
+            const bool keep
+                = (node.type == ObjectType::CAMERA || node.type == ObjectType::AMBIENT_LIGHT
+                   || node.type == ObjectType::POINT_LIGHT)
+                  && std::find(kept.begin(), kept.end(), node.type) == kept.end();
+
+            if (keep) kept.push_back(node.type);
+            return !keep;
+          });
+          selected = -1;
 
           ImGui::EndMenu();
         }
@@ -702,6 +924,7 @@ namespace bloom {
       {  // Modals
         if (m_modalSphere == true) ImGui::OpenPopup("add_sphere");
         if (m_modalCube == true) ImGui::OpenPopup("add_cube");
+        if (m_modalModel == true) ImGui::OpenPopup("add_model");
         if (m_modalLight == true) ImGui::OpenPopup("add_light");
 
         // Always center this window when appearing
@@ -718,6 +941,11 @@ namespace bloom {
           m_modalCube = false;
         }
 
+        if (ImGui::BeginPopupModal("add_model", NULL, ImGuiWindowFlags_AlwaysAutoResize)) {
+          addModel();
+          m_modalModel = false;
+        }
+
         if (ImGui::BeginPopupModal("add_light", NULL, ImGuiWindowFlags_AlwaysAutoResize)) {
           addLight();
           m_modalLight = false;
@@ -732,32 +960,89 @@ namespace bloom {
       ImGui::Separator();
 
       {
-        for (int32_t i = 0; i < hierarchyObjects.size(); i++) {
-          const auto object = hierarchyObjects[i];
-          // Get the index of the object in the std::vector
+        // Position of every entity in the hierarchy, by slot, for children reached through the
+        // transform links
+        m_hierarchyPositions.clear();
+        for (std::size_t i = 0; i < hierarchyEntities.size(); i++) {
+          const uint32_t slot = hierarchyEntities[i].index;
+          if (slot >= m_hierarchyPositions.size()) m_hierarchyPositions.resize(slot + 1, -1);
+          m_hierarchyPositions[slot] = (int32_t)i;
+        }
 
-          if (!object.visible) ImGui::PushStyleColor(ImGuiCol_Text, ImVec4(0.5f, 0.5f, 0.5f, 1.0f));
+        // Roots in hierarchy order, each followed by its children
+        HierarchyEdit edit;
+        for (std::size_t i = 0; i < hierarchyEntities.size(); i++) {
+          const ecs::EntityID entity = hierarchyEntities[i];
+          const ecs::Transform* transform = ecs::registry.tryGet<ecs::Transform>(entity);
+          if (!transform || transform->parent.isNull()) hierarchyEntry(entity, (int32_t)i, edit);
+        }
 
-          if (ImGui::Selectable(object.name.c_str(), selected == i)) {
-            selected = i;
-          }
-          if (ImGui::BeginPopupContextItem()) {
-            if (ImGui::MenuItem("Delete")) {
-              hierarchyObjects.erase(hierarchyObjects.begin() + i);
-              selected = -1;
-            }
-            ImGui::EndPopup();
+        if (edit.reparent) ecs::setParent(edit.child, edit.parent);
+        if (edit.removed != -1) {
+          removeFromHierarchy(edit.removed);
+          selected = -1;
+        }
+      }
+
+      ImGui::End();
+    }
+
+    void Light::hierarchyEntry(ecs::EntityID entity, int32_t position, HierarchyEdit& edit) {
+      ecs::Transform* transform = ecs::registry.tryGet<ecs::Transform>(entity);
+      const bool visible = ecs::registry.get<ecs::Visibility>(entity).visible;
+
+      if (!visible) ImGui::PushStyleColor(ImGuiCol_Text, ImVec4(0.5f, 0.5f, 0.5f, 1.0f));
+
+      ImGui::PushID((int)entity.index);
+      if (ImGui::Selectable(getNode(entity).name.c_str(), selected == position)) {
+        selected = position;
+      }
+
+      // Dropping an object on another one makes it its child
+      if (transform) {
+        if (ImGui::BeginDragDropSource()) {
+          ImGui::SetDragDropPayload("HIERARCHY_ENTITY", &entity, sizeof(ecs::EntityID));
+          ImGui::Text("%s", getNode(entity).name.c_str());
+          ImGui::EndDragDropSource();
+        }
+
+        if (ImGui::BeginDragDropTarget()) {
+          if (const ImGuiPayload* payload = ImGui::AcceptDragDropPayload("HIERARCHY_ENTITY")) {
+            edit.reparent = true;
+            edit.child = *(const ecs::EntityID*)payload->Data;
+            edit.parent = entity;
           }
+          ImGui::EndDragDropTarget();
+        }
+      }
 
-          if (!object.visible) ImGui::PopStyleColor();
+      if (ImGui::BeginPopupContextItem()) {
+        if (transform && !transform->parent.isNull() && ImGui::MenuItem("Unparent")) {
+          edit.reparent = true;
+          edit.child = entity;
+          edit.parent = {};
         }
+        if (ImGui::MenuItem("Delete")) edit.removed = position;
+        ImGui::EndPopup();
       }
+      ImGui::PopID();
 
-      ImGui::End();
+      if (!visible) ImGui::PopStyleColor();
+
+      if (!transform || transform->firstChild.isNull()) return;
+
+      ImGui::Indent();
+      for (ecs::EntityID child = transform->firstChild; !child.isNull();) {
+        const ecs::EntityID next = ecs::registry.get<ecs::Transform>(child).nextSibling;
+        if (ecs::registry.has<HierarchyNode>(child))
+          hierarchyEntry(child, m_hierarchyPositions[child.index], edit);
+        child = next;
+      }
+      ImGui::Unindent();
     }
 
     void Light::addSphere(std::string* name, glm::vec3* position, float* radius) {
-      const auto size = getObjectByType<ObjectType::SPHERE>().size();
+      const auto size = countObjects(ObjectType::SPHERE);
       const std::string repeated = fmt::format("({})", size);
       const std::string sphereName = fmt::format("Sphere{}", size >= 1 ? repeated : "");
 
@@ -807,19 +1092,15 @@ namespace bloom {
 
         // Check if the name is unique
         std::string name = namePtrSphere;
-        if (std::any_of(hierarchyObjects.begin(), hierarchyObjects.end(),
-                        [name](const Objects& object) { return object.name == name; })) {
+        if (hasObjectNamed(name)) {
           errorMessageSphere = fmt::format("The name \"{}\" is already in use", name);
           goto not_adding;
         }
 
-        hierarchyObjects.emplace_back(Objects{
-            ObjectType::SPHERE,
-            namePtrSphere,
-            (int32_t)getObjectByType<ObjectType::SPHERE>().size(),
-            {.sphere
-             = new bloom::Sphere(resultPositionSphere, resultColorSphere, resultRadiusSphere,
-                                 resultSectorSphere, resultStackSphere)}});
+        addToHierarchy(ObjectType::SPHERE, namePtrSphere,
+                       new bloom::Sphere(resultPositionSphere, resultColorSphere,
+                                         resultRadiusSphere, resultSectorSphere,
+                                         resultStackSphere));
         ImGui::CloseCurrentPopup();
       }
     not_adding:
@@ -834,7 +1115,7 @@ namespace bloom {
     }
 
     void Light::addCube(std::string* name, glm::vec3* position, float* side) {
-      const auto size = getObjectByType<ObjectType::CUBE>().size();
+      const auto size = countObjects(ObjectType::CUBE);
       const std::string repeated = fmt::format("({})", size);
       const std::string cubeName = fmt::format("Cube{}", size >= 1 ? repeated : "");
 
@@ -877,17 +1158,13 @@ namespace bloom {
 
         // Check if the name is unique
         std::string name = namePtrCube;
-        if (std::any_of(hierarchyObjects.begin(), hierarchyObjects.end(),
-                        [name](const Objects& object) { return object.name == name; })) {
+        if (hasObjectNamed(name)) {
           errorMessageCube = fmt::format("The name \"{}\" is already in use", name);
           goto not_adding;
         }
 
-        hierarchyObjects.emplace_back(Objects{
-            ObjectType::CUBE,
-            namePtrCube,
-            (int32_t)getObjectByType<ObjectType::CUBE>().size(),
-            {.cube = new bloom::Cube(resultPositionCube, resultSideCube, resultColorCube)}});
+        addToHierarchy(ObjectType::CUBE, namePtrCube,
+                       new bloom::Cube(resultPositionCube, resultSideCube, resultColorCube));
         ImGui::CloseCurrentPopup();
       }
     not_adding:
@@ -901,8 +1178,82 @@ namespace bloom {
       m_modalCube = false;
     }
 
+    void Light::addModel() {
+      const auto size = countObjects(ObjectType::MODEL);
+      const std::string repeated = fmt::format("({})", size);
+      const std::string modelName = fmt::format("Model{}", size >= 1 ? repeated : "");
+
+      if (!m_editingModel) {
+        std::snprintf(namePtrModel, sizeof(namePtrModel), "%s", modelName.c_str());
+
+        resultPositionModel = glm::vec3(0.0f);
+        resultSizeModel = 1.0f;
+        resultColorModel = glm::vec3(0.8f, 0.8f, 0.8f);
+        errorMessageModel.clear();
+
+        m_editingModel = true;
+      }
+
+      if (!errorMessageModel.empty()) {
+        ImGui::TextColored(ImVec4(1.0f, 0.3f, 0.3f, 1.0f), "%s", errorMessageModel.c_str());
+      }
+
+      ImGui::InputText("Name", namePtrModel, sizeof(namePtrModel));
+      ImGui::SameLine();
+      HelpMarker("The name of the model *MUST* be unique.\n");
+      ImGui::Separator();
+
+      ImGui::InputText("File", pathModel, sizeof(pathModel));
+      ImGui::SameLine();
+      HelpMarker(
+          "Wavefront .obj or .ply (ascii or binary) file. The mesh is fitted in a cube of half "
+          "side \"Size\", files already loaded are reused.\n");
+      ImGui::Separator();
+
+      ImGui::InputFloat3("Position", glm::value_ptr(resultPositionModel));
+      ImGui::Separator();
+
+      ImGui::InputFloat("Size", &resultSizeModel);
+      ImGui::Spacing();
+
+      ImGui::ColorEdit3("Color", glm::value_ptr(resultColorModel));
+      ImGui::Spacing();
+
+      if (ImGui::Button("OK", ImVec2(120, 0))) {
+        // Check if the name is unique
+        std::string name = namePtrModel;
+        if (hasObjectNamed(name)) {
+          errorMessageModel = fmt::format("The name \"{}\" is already in use", name);
+          goto not_adding;
+        }
+
+        std::string error;
+        auto mesh = bloom::Model::loadMesh(pathModel, error);
+        if (!mesh) {
+          errorMessageModel = error;
+          goto not_adding;
+        }
+
+        m_editingModel = false;
+        addToHierarchy(ObjectType::MODEL, name,
+                       new bloom::Model(mesh, pathModel, resultPositionModel, resultSizeModel,
+                                        resultColorModel));
+        ImGui::CloseCurrentPopup();
+      }
+    not_adding:
+      ImGui::SetItemDefaultFocus();
+      ImGui::SameLine();
+      if (ImGui::Button("Cancel", ImVec2(120, 0))) {
+        m_editingModel = false;
+        ImGui::CloseCurrentPopup();
+      }
+      ImGui::EndPopup();
+
+      m_modalModel = false;
+    }
+
     void Light::addLight(std::string* name, glm::vec3* position) {
-      const auto size = getObjectByType<ObjectType::POINT_LIGHT>().size();
+      const auto size = countObjects(ObjectType::POINT_LIGHT);
       const std::string repeated = fmt::format("({})", size);
       const std::string cubeName = fmt::format("Point Light {}", size >= 1 ? repeated : "");
 
@@ -937,23 +1288,13 @@ namespace bloom {
 
         // Check if the name is unique
         std::string name = namePtrLight;
-        if (std::any_of(hierarchyObjects.begin(), hierarchyObjects.end(),
-                        [name](const Objects& object) { return object.name == name; })) {
+        if (hasObjectNamed(name)) {
           errorMessageLight = fmt::format("The name \"{}\" is already in use", name);
           goto not_adding;
         }
 
-        // Check if there's less than 8 lights
-        if (getObjectByType<ObjectType::POINT_LIGHT>().size() >= 8) {
-          errorMessageLight = "There's already 8 lights";
-          goto not_adding;
-        }
-
-        hierarchyObjects.emplace_back(Objects{
-            ObjectType::POINT_LIGHT,
-            namePtrLight,
-            (int32_t)getObjectByType<ObjectType::POINT_LIGHT>().size(),
-            {.pointLight = new bloom::PointLight(resultPositionLight, resultIntensityLight)}});
+        addToHierarchy(ObjectType::POINT_LIGHT, namePtrLight,
+                       new bloom::PointLight(resultPositionLight, resultIntensityLight));
         ImGui::CloseCurrentPopup();
       }
     not_adding:
@@ -970,8 +1311,9 @@ namespace bloom {
     void Light::enableGuizmo() {
       if (selected == -1) return;
 
-      if (instanceof <bloom::Camera, bloom::AmbientLight>(hierarchyObjects[selected].get())) return;
-      if (!hierarchyObjects[selected].visible) return;
+      const ecs::EntityID entity = hierarchyEntities[selected];
+      if (instanceof <bloom::Camera, bloom::AmbientLight>(getNode(entity).object.get())) return;
+      if (!ecs::registry.get<ecs::Visibility>(entity).visible) return;
 
       ImGuizmo::SetDrawlist(bloom::Renderer::getViewportDrawList());
       ImGuizmo::SetOrthographic(false);
@@ -984,18 +1326,16 @@ namespace bloom {
 
       ImGuizmo::SetRect(windowPosX, windowPosY, windowWidth, windowHeight);
 
+      // Moved in world space, children follow their parent
       glm::mat4 model = glm::mat4(1.0f);
-      auto selectedModel = (bloom::Object*)hierarchyObjects[selected].get();
-
-      model = glm::translate(model, selectedModel->getAppliedTransformation());
+      model = glm::translate(model, ecs::registry.get<ecs::Transform>(entity).getWorldPosition());
 
       ImGuizmo::Manipulate(
           glm::value_ptr(cameraObject->getViewMatrix()),
           glm::value_ptr(cameraObject->getViewportMatrix() * cameraObject->getProjectionMatrix()),
           ImGuizmo::OPERATION::TRANSLATE, ImGuizmo::WORLD, glm::value_ptr(model));
 
-      if (ImGuizmo::IsUsing())
-        ((bloom::Object*)selectedModel)->setAppliedTransformation(glm::vec3(model[3]));
+      if (ImGuizmo::IsUsing()) ecs::setWorldPosition(entity, glm::vec3(model[3]));
     }
 
     void Light::guizmoController() {
@@ -1052,6 +1392,23 @@ namespace bloom {
                                ImVec2(128, 128), 0x11111110);
     }
 
+    Light* Light::setInstancedRendering(bool enabled) {
+      m_instancedRendering = enabled;
+      return this;
+    }
+
+    Light* Light::setClusteredShading(bool enabled) {
+      m_clusteredShading = enabled;
+      return this;
+    }
+
+    Light* Light::setOrbitLights(bool enabled) {
+      m_orbitLights = enabled;
+      return this;
+    }
+
+    bloom::Camera* Light::getCamera() const { return cameraObject; }
+
     void Light::onImGuiRender() {
       hierarchy();
       inspector();
@@ -1060,6 +1417,7 @@ namespace bloom {
 
       ImGui::Text("Application average %.3f ms/frame (%.1f FPS)",
                   1000.0f / ImGui::GetIO().Framerate, ImGui::GetIO().Framerate);
+      ImGui::Text("Triangles saved by LOD: %llu", (unsigned long long)m_lodTrianglesSaved);
     }
   }  // namespace scene
 }  // namespace bloom
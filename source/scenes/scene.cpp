@@ -2,7 +2,11 @@
 #include <imgui_impl_glfw.h>
 #include <imgui_impl_opengl3.h>
 
+#include <bloomCG/core/job_system.hpp>
+#include <bloomCG/models/mesh.hpp>
 #include <bloomCG/scenes/scene.hpp>
+#include <bloomCG/structures/components.hpp>
+#include <bloomCG/structures/registry.hpp>
 
 namespace bloom {
   namespace scene {
@@ -11,10 +15,26 @@ namespace bloom {
       __deltaTime = currentFrame - __lastFrame;
       __lastFrame = currentFrame;
 
+      // GL work queued by jobs, and the meshes generated in the background since the last frame
+      // are swapped in before drawing
+      bloom::JobSystem::get().executeMainThreadJobs();
+      bloom::MeshRegistry::update();
+      updatePending();
+
       onUpdate(__deltaTime);
       onRender(__deltaTime);
     }
 
+    void Scene::updatePending() {
+      auto& pending = ecs::registry.pool<ecs::PendingUpdate>();
+
+      std::vector<ecs::EntityID> done;
+      for (std::size_t i = 0; i < pending.size(); i++)
+        if (pending[i].poll()) done.push_back(pending.getEntity(i));
+
+      for (ecs::EntityID entity : done) pending.remove(entity);
+    }
+
     // Menu
     Menu::Menu(Scene*& currentScenePointer) : m_current(currentScenePointer) {}
 
@@ -0,0 +1,50 @@
+#include <bloomCG/structures/registry.hpp>
+
+namespace bloom {
+  namespace ecs {
+    Registry::~Registry() { clear(); }
+
+    EntityID Registry::create() {
+      uint32_t index;
+      if (!m_free.empty()) {
+        index = m_free.back();
+        m_free.pop_back();
+      } else {
+        index = m_slots.size();
+        m_slots.emplace_back();
+      }
+
+      m_slots[index].alive = true;
+      m_alive++;
+
+      return {index, m_slots[index].generation};
+    }
+
+    void Registry::destroy(EntityID entity) {
+      if (!isAlive(entity)) return;
+
+      m_slots[entity.index].generation++;
+      m_slots[entity.index].alive = false;
+      m_free.push_back(entity.index);
+      m_alive--;
+
+      // Indexed, a component destructor may create the pool of another type
+      for (std::size_t i = 0; i < m_pools.size(); i++)
+        if (m_pools[i]) m_pools[i]->remove(entity);
+    }
+
+    void Registry::clear() {
+      m_free.clear();
+      for (uint32_t index = 0; index < m_slots.size(); index++) {
+        if (m_slots[index].alive) m_slots[index].generation++;
+
+        m_slots[index].alive = false;
+        m_free.push_back(index);
+      }
+      m_alive = 0;
+
+      for (std::size_t i = 0; i < m_pools.size(); i++)
+        if (m_pools[i]) m_pools[i]->clear();
+    }
+  }  // namespace ecs
+}  // namespace bloom
@@ -0,0 +1,109 @@
+#include <bloomCG/core/job_system.hpp>
+#include <bloomCG/structures/transform_system.hpp>
+
+namespace bloom {
+  namespace ecs {
+    // Roots walked by each job, with their subtrees
+    static constexpr std::size_t TRANSFORMS_PER_JOB = 256;
+
+    static void unlink(EntityID entity, Transform& transform) {
+      if (transform.parent.isNull()) return;
+
+      Transform& parent = registry.get<Transform>(transform.parent);
+      if (parent.firstChild == entity) {
+        parent.firstChild = transform.nextSibling;
+      } else {
+        EntityID sibling = parent.firstChild;
+        while (registry.get<Transform>(sibling).nextSibling != entity)
+          sibling = registry.get<Transform>(sibling).nextSibling;
+
+        registry.get<Transform>(sibling).nextSibling = transform.nextSibling;
+      }
+
+      transform.parent = transform.nextSibling = EntityID{};
+    }
+
+    bool isDescendant(EntityID entity, EntityID ancestor) {
+      for (; !entity.isNull(); entity = registry.get<Transform>(entity).parent)
+        if (entity == ancestor) return true;
+
+      return false;
+    }
+
+    bool setParent(EntityID child, EntityID parent) {
+      if (!parent.isNull() && isDescendant(parent, child)) return false;
+
+      Transform& transform = registry.get<Transform>(child);
+      unlink(child, transform);
+
+      if (!parent.isNull()) {
+        Transform& parentTransform = registry.get<Transform>(parent);
+        transform.parent = parent;
+        transform.nextSibling = parentTransform.firstChild;
+        parentTransform.firstChild = child;
+      }
+
+      transform.markDirty();
+      return true;
+    }
+
+    void detach(EntityID entity) {
+      Transform* transform = registry.tryGet<Transform>(entity);
+      if (!transform) return;
+
+      unlink(entity, *transform);
+
+      for (EntityID child = transform->firstChild; !child.isNull();) {
+        Transform& childTransform = registry.get<Transform>(child);
+        child = childTransform.nextSibling;
+
+        childTransform.parent = childTransform.nextSibling = EntityID{};
+        childTransform.markDirty();
+      }
+      transform->firstChild = EntityID{};
+    }
+
+    void setWorldPosition(EntityID entity, const glm::vec3& position) {
+      Transform& transform = registry.get<Transform>(entity);
+      if (transform.parent.isNull()) {
+        transform.setPosition(position);
+        return;
+      }
+
+      const glm::mat4& parentWorld = registry.get<Transform>(transform.parent).getWorldMatrix();
+      transform.setPosition(glm::vec3(glm::inverse(parentWorld) * glm::vec4(position, 1.0f)));
+    }
+
+    // Only reached through its root, so subtrees of different roots never share a transform
+    static void updateSubtree(ComponentPool<Transform>& transforms, Transform& transform,
+                              const Transform* parent, bool changed) {
+      static const glm::mat4 identity = glm::mat4(1.0f);
+      static const glm::mat3 identityNormal = glm::mat3(1.0f);
+
+      changed = changed || transform.isDirty();
+      if (changed) {
+        transform.updateWorld(parent ? parent->getWorldMatrix() : identity,
+                              parent ? parent->getNormalMatrix() : identityNormal);
+      }
+
+      for (EntityID child = transform.firstChild; !child.isNull();) {
+        Transform& childTransform = transforms.get(child);
+        updateSubtree(transforms, childTransform, &transform, changed);
+        child = childTransform.nextSibling;
+      }
+    }
+
+    void updateTransforms() {
+      // Resolved here, the jobs below must not touch the registry itself
+      ComponentPool<Transform>& transforms = registry.pool<Transform>();
+
+      const auto update = [&transforms](std::size_t begin, std::size_t end) {
+        for (std::size_t i = begin; i < end; i++) {
+          Transform& transform = transforms[i];
+          if (transform.parent.isNull()) updateSubtree(transforms, transform, nullptr, false);
+        }
+      };
+      JobSystem::get().parallelFor(transforms.size(), TRANSFORMS_PER_JOB, update);
+    }
+  }  // namespace ecs
+}  // namespace bloom
@@ -5,6 +5,7 @@
 #include <3rd-party/IconFontCppHeaders/IconsFontAwesome5.hpp>
 #include <bloomCG/core/core.hpp>
 #include <bloomCG/core/input.hpp>
+#include <bloomCG/core/profiler.hpp>
 #include <bloomCG/core/renderer.hpp>
 #include <bloomCG/scenes/light.hpp>
 #include <bloomCG/scenes/scene.hpp>
@@ -68,6 +69,11 @@ int main(void) {
     monitor_map[name] = i;
   }
 
+#ifdef BLOOM_GL_DEBUG
+  // Errors are reported through KHR_debug, which is only guaranteed on debug contexts
+  glfwWindowHint(GLFW_OPENGL_DEBUG_CONTEXT, GLFW_TRUE);
+#endif
+
   // Attach window to monitor "eDP"
   window = glfwCreateWindow(WIDTH, HEIGHT, "BloomCG", NULL, NULL);
   if (!window) {
@@ -83,6 +89,10 @@ int main(void) {
     return -1;
   }
 
+#ifdef BLOOM_GL_DEBUG
+  bloom::gl::enableDebugOutput();
+#endif
+
   GLCall(glad_glViewport(0, 0, WIDTH, HEIGHT));
   glfwSetFramebufferSizeCallback(window, framebufferSizeCallback);
   glfwSwapInterval(1);
@@ -163,6 +173,8 @@ int main(void) {
 
   GLCall(glBindFramebuffer(GL_FRAMEBUFFER, 0));
   while (!glfwWindowShouldClose(window)) {
+    BLOOM_PROFILE_FRAME();
+
     renderer.clear();
     glfwPollEvents();
     glClearColor(0.1f, 0.1f, 0.1f, 1.0f);
@@ -215,7 +227,11 @@ int main(void) {
     if (currentScene) {
       GLCall(glBindFramebuffer(GL_FRAMEBUFFER, fbo));
       GLCall(glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, tex, 0));
-      currentScene->onSceneRender();
+      {
+        BLOOM_PROFILE_SCOPE("Scene");
+        BLOOM_PROFILE_GPU_SCOPE("Scene");
+        currentScene->onSceneRender();
+      }
 
       ImGui::Begin("BloomGL");
       {
@@ -225,18 +241,32 @@ int main(void) {
         }
 
         GLCall(glBindFramebuffer(GL_FRAMEBUFFER, 0));
+        BLOOM_PROFILE_SCOPE("Scene UI");
         currentScene->onImGuiRender();
         renderer.clear();
       }
       ImGui::End();
     }
 
-    ImGui::Render();
-    ImGui_ImplOpenGL3_RenderDrawData(ImGui::GetDrawData());
+    BLOOM_PROFILE_PANEL();
 
-    glfwSwapBuffers(window);
+    {
+      BLOOM_PROFILE_SCOPE("ImGui");
+      BLOOM_PROFILE_GPU_SCOPE("ImGui");
+      ImGui::Render();
+      ImGui_ImplOpenGL3_RenderDrawData(ImGui::GetDrawData());
+    }
+
+    {
+      BLOOM_PROFILE_SCOPE("Swap");
+      glfwSwapBuffers(window);
+    }
   }
 
+  // Scenes release their GL objects, the context must still be current
+  if (currentScene != menu) delete currentScene;
+  delete menu;
+
   ImGui_ImplOpenGL3_Shutdown();
   ImGui_ImplGlfw_Shutdown();
   ImGui::DestroyContext();
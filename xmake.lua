@@ -1,6 +1,26 @@
 set_languages("cxx17")
 add_rules("mode.debug", "mode.release")
 
+-- GL error checking policy, see GLCall in include/bloomCG/core/core.hpp
+option("gl_strict")
+  set_default(false)
+  set_showmenu(true)
+  set_description("Poll glGetError after every GL call (slow, pinpoints the failing call)")
+  add_defines("BLOOM_GL_STRICT")
+option_end()
+
+-- Frame profiler, see include/bloomCG/core/profiler.hpp
+option("profiler")
+  set_default(false)
+  set_showmenu(true)
+  set_description("Collect CPU/GPU frame timings and show them in a Profiler panel")
+  add_defines("BLOOM_PROFILE")
+option_end()
+
+if is_mode("debug") then
+  add_defines("BLOOM_GL_DEBUG")
+end
+
 local libs = { "fmt", "glad", "glfw", "glm", "imguizmo" }
 
 add_includedirs("include")
@@ -21,11 +41,17 @@ target("bloom_lib")
   set_kind("static")
   add_files("source/**/*.cpp")
   add_packages(table.unpack(libs))
+  add_options("gl_strict", "profiler")
+  -- Mesh importer worker threads
+  if is_plat("linux") then
+    add_syslinks("pthread", { public = true })
+  end
 
 target("BloomCG")
   set_kind("binary")
   add_files("standalone/main.cpp")
   add_packages(table.unpack(libs))
+  add_options("gl_strict", "profiler")
   add_deps("bloom_lib")
   after_build(function (target)
     -- Import task module
@@ -40,3 +66,11 @@ target("BloomCG")
     -- Move imgui.ini to the target directory
     os.cp("imgui.ini", dir)
   end)
+
+-- Offscreen benchmark, see bench/main.cpp
+target("bloom_bench")
+  set_kind("binary")
+  add_files("bench/main.cpp")
+  add_packages(table.unpack(libs))
+  add_options("gl_strict", "profiler")
+  add_deps("bloom_lib")